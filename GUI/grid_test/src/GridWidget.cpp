@@ -1,6 +1,10 @@
 #include "GridWidget.h"
+#include <QDir>
+#include <QFileInfo>
+#include <QKeyEvent>
 #include <QPainter>
 #include <QPainterPath>
+#include <QPolygonF>
 #include <QRectF>
 #include <QtMath>
 
@@ -9,6 +13,7 @@ GridWidget::GridWidget(QWidget* parent) : QWidget(parent)
     setAutoFillBackground(false);
     setAttribute(Qt::WA_OpaquePaintEvent, true);
     setAttribute(Qt::WA_NoSystemBackground, true);
+    setFocusPolicy(Qt::StrongFocus);   // calibration keys
 }
 
 static QColor neonGreen(int alpha = 255) {
@@ -17,6 +22,43 @@ static QColor neonGreen(int alpha = 255) {
     return c;
 }
 
+// Widget point -> where the projector must draw it
+QPointF GridWidget::warped(const QPointF& pt) const
+{
+    double x, y;
+    m_warp.forward(pt.x() / width(), pt.y() / height(), x, y);
+    return QPointF(x * width(), y * height());
+}
+
+// Straight lines stay exact without a warp; otherwise they are bent into
+// polylines (keystone keeps them straight, the radial term does not)
+void GridWidget::drawLine(QPainter& p, const QPointF& a, const QPointF& b) const
+{
+    if (m_warp.isIdentity()) {
+        p.drawLine(a, b);
+        return;
+    }
+    QPolygonF line;
+    const int n = m_warp.k1 == 0.0 ? 1 : 48;
+    for (int i = 0; i <= n; ++i)
+        line << warped(a + (b - a) * (double(i) / n));
+    p.drawPolyline(line);
+}
+
+void GridWidget::drawEllipse(QPainter& p, const QPointF& c, double r) const
+{
+    if (m_warp.isIdentity()) {
+        p.drawEllipse(c, r, r);
+        return;
+    }
+    QPolygonF ring;
+    for (int i = 0; i < 64; ++i) {
+        const double a = 2.0 * M_PI * i / 64.0;
+        ring << warped(c + QPointF(r * std::cos(a), r * std::sin(a)));
+    }
+    p.drawPolygon(ring);
+}
+
 void GridWidget::paintEvent(QPaintEvent*)
 {
     QPainter p(this);
@@ -39,7 +81,18 @@ void GridWidget::paintEvent(QPaintEvent*)
 
     // Clip to area so nothing bleeds outside
     p.save();
-    p.setClipRect(area);
+    if (m_warp.isIdentity()) {
+        p.setClipRect(area);
+    } else {
+        QPolygonF outline;
+        const QPointF corners[] = { area.topLeft(), area.topRight(), area.bottomRight(), area.bottomLeft() };
+        for (int k = 0; k < 4; ++k)
+            for (int i = 0; i < 32; ++i)
+                outline << warped(corners[k] + (corners[(k + 1) % 4] - corners[k]) * (i / 32.0));
+        QPainterPath clip;
+        clip.addPolygon(outline);
+        p.setClipPath(clip);
+    }
 
     const int N = m_divisions;
     const double step = area.width() / N;
@@ -55,12 +108,12 @@ void GridWidget::paintEvent(QPaintEvent*)
         // vertical lines
         for (int i = 0; i <= N; ++i) {
             const double x = area.left() + i * step;
-            p.drawLine(QPointF(x, area.top()), QPointF(x, area.bottom()));
+            drawLine(p, QPointF(x, area.top()), QPointF(x, area.bottom()));
         }
         // horizontal lines
         for (int j = 0; j <= N; ++j) {
             const double y = area.top() + j * step;
-            p.drawLine(QPointF(area.left(), y), QPointF(area.right(), y));
+            drawLine(p, QPointF(area.left(), y), QPointF(area.right(), y));
         }
     }
 
@@ -73,11 +126,11 @@ void GridWidget::paintEvent(QPaintEvent*)
 
     for (int i = 0; i <= N; ++i) {
         const double x = area.left() + i * step;
-        p.drawLine(QPointF(x, area.top()), QPointF(x, area.bottom()));
+        drawLine(p, QPointF(x, area.top()), QPointF(x, area.bottom()));
     }
     for (int j = 0; j <= N; ++j) {
         const double y = area.top() + j * step;
-        p.drawLine(QPointF(area.left(), y), QPointF(area.right(), y));
+        drawLine(p, QPointF(area.left(), y), QPointF(area.right(), y));
     }
 
     // Center reticle (circle + small cardinal ticks)
@@ -88,20 +141,20 @@ void GridWidget::paintEvent(QPaintEvent*)
             QPen rGlow(neonGreen(90));
             rGlow.setWidthF(m_lineW * 3.0);
             p.setPen(rGlow);
-            p.drawEllipse(c, step * 0.45, step * 0.45);
+            drawEllipse(p, c, step * 0.45);
         }
 
         p.setPen(gridPen);
-        p.drawEllipse(c, step * 0.40, step * 0.40);
+        drawEllipse(p, c, step * 0.40);
 
         const double tick = step * 0.35;
-        p.drawLine(QPointF(c.x() - tick, c.y()), QPointF(c.x() - tick*0.55, c.y()));
-        p.drawLine(QPointF(c.x() + tick, c.y()), QPointF(c.x() + tick*0.55, c.y()));
-        p.drawLine(QPointF(c.x(), c.y() - tick), QPointF(c.x(), c.y() - tick*0.55));
-        p.drawLine(QPointF(c.x(), c.y() + tick), QPointF(c.x(), c.y() + tick*0.55));
+        drawLine(p, QPointF(c.x() - tick, c.y()), QPointF(c.x() - tick*0.55, c.y()));
+        drawLine(p, QPointF(c.x() + tick, c.y()), QPointF(c.x() + tick*0.55, c.y()));
+        drawLine(p, QPointF(c.x(), c.y() - tick), QPointF(c.x(), c.y() - tick*0.55));
+        drawLine(p, QPointF(c.x(), c.y() + tick), QPointF(c.x(), c.y() + tick*0.55));
 
         // small center dot
-        p.drawEllipse(c, m_lineW*1.3, m_lineW*1.3);
+        drawEllipse(p, c, m_lineW*1.3);
     }
 
     // Diagonal line from center to top-right corner
@@ -110,15 +163,116 @@ void GridWidget::paintEvent(QPaintEvent*)
             QPen dGlow(neonGreen(80));
             dGlow.setWidthF(m_lineW * 3.0);
             p.setPen(dGlow);
-            p.drawLine(c, QPointF(area.right(), area.top()));
+            drawLine(p, c, QPointF(area.right(), area.top()));
         }
         p.setPen(gridPen);
-        p.drawLine(c, QPointF(area.right(), area.top()));
+        drawLine(p, c, QPointF(area.right(), area.top()));
     }
 
     p.restore();
 
+    if (m_calibrating) drawCalibration(p);
+
     // Optional: small info text (off by default; keep projection clean)
     // p.setPen(Qt::white);
     // p.drawText(20, 30, QString("Grid %1x%1").arg(N));
+}
+
+// Frame outline, corner handles and the key help
+void GridWidget::drawCalibration(QPainter& p)
+{
+    static const char* names[4] = { "TL", "TR", "BR", "BL" };
+    const QRectF full = rect();
+    const QPointF corners[] = { full.topLeft(), full.topRight(), full.bottomRight(), full.bottomLeft() };
+
+    QPolygonF frame;
+    for (int k = 0; k < 4; ++k)
+        for (int i = 0; i < 32; ++i)
+            frame << warped(corners[k] + (corners[(k + 1) % 4] - corners[k]) * (i / 32.0));
+    p.setPen(QPen(QColor(255, 255, 255, 120), 1.0, Qt::DashLine));
+    p.setBrush(Qt::NoBrush);
+    p.drawPolygon(frame);
+
+    for (int k = 0; k < 4; ++k) {
+        const QPointF c = warped(corners[k]);
+        p.setPen(QPen(k == m_corner ? QColor(255, 200, 0) : QColor(255, 255, 255, 160), 2.0));
+        p.drawEllipse(c, 10.0, 10.0);
+    }
+
+    const QString help = QString("corner %1 (%2)  x %3  y %4  k1 %5   "
+                                 "1-4 corner  arrows move (Shift x10)  [ ] radial  R reset  S save  L load  C done")
+                             .arg(m_corner + 1).arg(names[m_corner])
+                             .arg(m_warp.cornerX[m_corner], 0, 'f', 4)
+                             .arg(m_warp.cornerY[m_corner], 0, 'f', 4)
+                             .arg(m_warp.k1, 0, 'f', 3);
+    p.setPen(Qt::white);
+    p.drawText(QRectF(full.adjusted(12, 12, -12, -12)), Qt::AlignBottom | Qt::AlignLeft,
+               m_status.isEmpty() ? help : help + "\n" + m_status);
+}
+
+void GridWidget::resizeEvent(QResizeEvent* e)
+{
+    m_warp.aspect = aspect();
+    QWidget::resizeEvent(e);
+}
+
+void GridWidget::keyPressEvent(QKeyEvent* e)
+{
+    if (e->key() == Qt::Key_C) {
+        setCalibrating(!m_calibrating);
+        return;
+    }
+    if (!m_calibrating) {
+        QWidget::keyPressEvent(e);
+        return;
+    }
+
+    // One step is a pixel of the output
+    const double k = (e->modifiers() & Qt::ShiftModifier) ? 10.0 : 1.0;
+    const double dx = k / qMax(1, width()), dy = k / qMax(1, height());
+    switch (e->key()) {
+    case Qt::Key_1: case Qt::Key_2: case Qt::Key_3: case Qt::Key_4:
+        m_corner = e->key() - Qt::Key_1;
+        break;
+    case Qt::Key_Left:  m_warp.cornerX[m_corner] -= dx; break;
+    case Qt::Key_Right: m_warp.cornerX[m_corner] += dx; break;
+    case Qt::Key_Up:    m_warp.cornerY[m_corner] -= dy; break;
+    case Qt::Key_Down:  m_warp.cornerY[m_corner] += dy; break;
+    case Qt::Key_BracketLeft:  m_warp.k1 -= 0.005; break;
+    case Qt::Key_BracketRight: m_warp.k1 += 0.005; break;
+    case Qt::Key_R:
+        m_warp = WarpParams();
+        m_warp.aspect = aspect();
+        break;
+    case Qt::Key_S:
+        m_status = saveWarp() ? "saved " + m_warpFile : "could not save " + m_warpFile;
+        break;
+    case Qt::Key_L:
+        m_status = loadWarp() ? "loaded " + m_warpFile : "could not load " + m_warpFile;
+        break;
+    default:
+        QWidget::keyPressEvent(e);
+        return;
+    }
+    update();
+}
+
+// The file holds the params (for editing here) and the inverse mesh the HUD
+// remaps with; a mesh without params (hand-edited) is not loaded
+bool GridWidget::loadWarp()
+{
+    WarpMesh mesh;
+    if (m_warpFile.isEmpty() || !mesh.load(m_warpFile.toStdString()) || !mesh.hasParams())
+        return false;
+    setWarpParams(mesh.params());
+    return true;
+}
+
+bool GridWidget::saveWarp()
+{
+    if (m_warpFile.isEmpty()) return false;
+    WarpParams p = m_warp;
+    p.aspect = aspect();
+    QDir().mkpath(QFileInfo(m_warpFile).absolutePath());
+    return WarpMesh::fromParams(p).save(m_warpFile.toStdString());
 }
\ No newline at end of file
@@ -1,6 +1,12 @@
 #pragma once
+#include <QPointF>
+#include <QString>
 #include <QWidget>
 
+#include "WarpMesh.h"
+
+class QPainter;
+
 class GridWidget : public QWidget {
     Q_OBJECT
 public:
@@ -13,8 +19,22 @@ public:
     void setShowDiagonal(bool on) { m_diagonal = on; update(); }
     void setShowReticle(bool on) { m_reticle = on; update(); }
 
+    // Projector warp: the grid is drawn pre-warped so it can be tuned until
+    // it looks square on the combiner. In calibration mode: 1-4 pick a
+    // corner (TL TR BR BL), arrows move it (Shift = x10), [ ] change the
+    // radial term, R resets, S saves the mesh to the warp file, L reloads
+    // it, C toggles calibration.
+    void setWarpParams(const WarpParams& p) { m_warp = p; m_warp.aspect = aspect(); update(); }
+    const WarpParams& warpParams() const { return m_warp; }
+    void setWarpFile(const QString& path) { m_warpFile = path; }
+    bool loadWarp();
+    bool saveWarp();
+    void setCalibrating(bool on) { m_calibrating = on; update(); }
+
 protected:
     void paintEvent(QPaintEvent* e) override;
+    void resizeEvent(QResizeEvent* e) override;
+    void keyPressEvent(QKeyEvent* e) override;
 
 private:
     int m_divisions = 12;       // number of squares across
@@ -22,4 +42,16 @@ private:
     bool m_glow = true;         // faux glow (draw thicker faint pass behind)
     bool m_diagonal = true;     // diagonal from center to top-right
     bool m_reticle = true;      // center target marker
+
+    WarpParams m_warp;
+    QString m_warpFile;
+    QString m_status;           // last save / load result
+    bool m_calibrating = false;
+    int m_corner = 0;
+
+    double aspect() const { return height() > 0 ? double(width()) / height() : 16.0 / 9.0; }
+    QPointF warped(const QPointF& pt) const;
+    void drawLine(QPainter& p, const QPointF& a, const QPointF& b) const;
+    void drawEllipse(QPainter& p, const QPointF& c, double r) const;
+    void drawCalibration(QPainter& p);
 };
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include <QApplication>
 #include <QCommandLineParser>
 #include <QScreen>
+#include <QStandardPaths>
 #include <QTimer>
 
 #include "GridWidget.h"
@@ -25,12 +26,21 @@ int main(int argc, char* argv[])
                                  "Disable diagonal line.");
     QCommandLineOption noRetOpt(QStringList() << "no-reticle",
                                  "Disable center reticle.");
+    QCommandLineOption warpFileOpt(QStringList() << "warp-file",
+                                   "Projector warp file (shared with the HUD's --warp).",
+                                   "file",
+                                   QStandardPaths::writableLocation(QStandardPaths::GenericConfigLocation)
+                                       + "/PEGASUS HUD/warp.txt");
+    QCommandLineOption calibrateOpt(QStringList() << "calibrate",
+                                    "Start in warp calibration mode (C toggles it).");
 
     parser.addOption(devOpt);
     parser.addOption(divisionsOpt);
     parser.addOption(noGlowOpt);
     parser.addOption(noDiagOpt);
     parser.addOption(noRetOpt);
+    parser.addOption(warpFileOpt);
+    parser.addOption(calibrateOpt);
     parser.process(app);
 
     const bool devMode = parser.isSet(devOpt);
@@ -40,6 +50,9 @@ int main(int argc, char* argv[])
     w.setGlow(!parser.isSet(noGlowOpt));
     w.setShowDiagonal(!parser.isSet(noDiagOpt));
     w.setShowReticle(!parser.isSet(noRetOpt));
+    w.setWarpFile(parser.value(warpFileOpt));
+    w.loadWarp();
+    w.setCalibrating(parser.isSet(calibrateOpt));
 
     w.resize(1280, 720);
     w.show();
@@ -0,0 +1,81 @@
+#include "AhrsFilter.h"
+#include "AhrsKernel.h"
+#include "AttitudeMath.h"
+
+#include <cmath>
+
+void AhrsFilter::reset()
+{
+    m_q0 = 1.0; m_q1 = 0.0; m_q2 = 0.0; m_q3 = 0.0;
+    m_lastTsUs = 0;
+    m_init = false;
+}
+
+void AhrsFilter::initFromAccel(double ax, double ay, double az)
+{
+    const double roll  = std::atan2(ay, az);
+    const double pitch = std::atan2(-ax, std::sqrt(ay*ay + az*az));
+
+    const double cr = std::cos(roll * 0.5),  sr = std::sin(roll * 0.5);
+    const double cp = std::cos(pitch * 0.5), sp = std::sin(pitch * 0.5);
+
+    // ZYX euler -> quaternion with yaw = 0
+    m_q0 = cr * cp;
+    m_q1 = sr * cp;
+    m_q2 = cr * sp;
+    m_q3 = -sr * sp;
+    m_init = true;
+}
+
+void AhrsFilter::update(double gx, double gy, double gz,
+                        double ax, double ay, double az, double dtSec)
+{
+    madgwickImuStep(m_q0, m_q1, m_q2, m_q3, gx, gy, gz, ax, ay, az, m_beta, dtSec);
+}
+
+double AhrsFilter::advanceClock(long long tsUs, double ax, double ay, double az)
+{
+    const double dt = (tsUs - m_lastTsUs) * 1e-6;
+    const bool haveAccel = (ax != 0.0 || ay != 0.0 || az != 0.0);
+    m_lastTsUs = tsUs;
+
+    if (!m_init || dt <= 0.0 || dt > m_maxGapSec) {
+        // First sample, clock went backwards, or a long dropout:
+        // integrating across it would be meaningless, so start over from gravity.
+        if (haveAccel) initFromAccel(ax, ay, az);
+        return -1.0;
+    }
+    return dt;
+}
+
+void AhrsFilter::updateAt(long long tsUs,
+                          double gx, double gy, double gz,
+                          double ax, double ay, double az)
+{
+    const double dt = advanceClock(tsUs, ax, ay, az);
+    if (dt > 0.0) update(gx, gy, gz, ax, ay, az, dt);
+}
+
+double AhrsFilter::rollRad() const
+{
+    return quatRollRad(m_q0, m_q1, m_q2, m_q3);
+}
+
+double AhrsFilter::pitchRad() const
+{
+    return quatPitchRad(m_q0, m_q1, m_q2, m_q3);
+}
+
+double AhrsFilter::yawRad() const
+{
+    return quatYawRad(m_q0, m_q1, m_q2, m_q3);
+}
+
+double AhrsFilter::upComponent(double x, double y, double z) const
+{
+    // Third row of the body->earth rotation matrix
+    const double ux = 2.0 * (m_q1 * m_q3 - m_q0 * m_q2);
+    const double uy = 2.0 * (m_q0 * m_q1 + m_q2 * m_q3);
+    const double uz = m_q0 * m_q0 - m_q1 * m_q1 - m_q2 * m_q2 + m_q3 * m_q3;
+    return x * ux + y * uy + z * uz;
+}
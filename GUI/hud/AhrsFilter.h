@@ -0,0 +1,66 @@
+#pragma once
+
+// Madgwick gradient-descent orientation filter (gyro + accelerometer).
+// Fixed cost per sample (no allocation, no history) so it can run on the host
+// for every frame coming off the UART.
+//
+// Inputs are in the sensor frame used by UartCborSource:
+//  gx/gy/gz in rad/s, ax/ay/az in any unit (only the direction is used).
+// Roll/pitch agree with the old accel-only fallback when the unit is at rest.
+
+class AhrsFilter {
+public:
+    explicit AhrsFilter(double beta = 0.1) : m_beta(beta) {}
+
+    // beta: how hard the accelerometer pulls the gyro solution back.
+    // ~0.03 smooth / slow to settle, ~0.3 fast but passes vibration through.
+    void setBeta(double beta) { m_beta = beta; }
+    double beta() const { return m_beta; }
+
+    // Gaps longer than this re-seed from the accelerometer instead of integrating.
+    void setMaxGapSec(double s) { m_maxGapSec = s; }
+
+    void reset();
+    bool isInitialized() const { return m_init; }
+
+    // Seed roll/pitch from gravity alone (yaw = 0).
+    void initFromAccel(double ax, double ay, double az);
+
+    // One filter step over dtSec.
+    void update(double gx, double gy, double gz,
+                double ax, double ay, double az, double dtSec);
+
+    // Same, but dt comes from consecutive device timestamps.
+    void updateAt(long long tsUs,
+                  double gx, double gy, double gz,
+                  double ax, double ay, double az);
+
+    // The timestamp half of updateAt(): returns the dt to integrate over, or
+    // a negative value if this sample (re)seeded the filter instead.
+    // BatchFusion uses it to run the step itself across SIMD lanes.
+    double advanceClock(long long tsUs, double ax, double ay, double az);
+
+    double rollRad() const;
+    double pitchRad() const;
+    double yawRad() const;
+
+    // Component of a body-frame vector along earth "up" (e.g. the accel
+    // reading minus g gives vertical linear acceleration).
+    double upComponent(double x, double y, double z) const;
+
+    double q0() const { return m_q0; }
+    double q1() const { return m_q1; }
+    double q2() const { return m_q2; }
+    double q3() const { return m_q3; }
+    void setQuaternion(double q0, double q1, double q2, double q3) {
+        m_q0 = q0; m_q1 = q1; m_q2 = q2; m_q3 = q3;
+    }
+
+private:
+    double m_q0 = 1.0, m_q1 = 0.0, m_q2 = 0.0, m_q3 = 0.0;
+    double m_beta;
+    double m_maxGapSec = 0.5;
+
+    long long m_lastTsUs = 0;
+    bool m_init = false;
+};
@@ -0,0 +1,60 @@
+#pragma once
+#include "SimdLanes.h"
+
+// Madgwick IMU step, written once and instantiated for double (AhrsFilter)
+// and DVec (BatchFusion). Both branches are evaluated and blended with
+// select() so the lane version is branch-free; since only correctly-rounded
+// operations are used, the two instantiations agree bit for bit.
+template <typename T>
+inline void madgwickImuStep(T& q0, T& q1, T& q2, T& q3,
+                            T gx, T gy, T gz,
+                            T ax, T ay, T az,
+                            T beta, T dt)
+{
+    using std::sqrt;
+    const T zero(0.0), half(0.5), one(1.0), two(2.0), four(4.0), eight(8.0);
+
+    // Rate of change of quaternion from gyroscope
+    T qDot0 = half * (-q1 * gx - q2 * gy - q3 * gz);
+    T qDot1 = half * ( q0 * gx + q2 * gz - q3 * gy);
+    T qDot2 = half * ( q0 * gy - q1 * gz + q3 * gx);
+    T qDot3 = half * ( q0 * gz + q1 * gy - q2 * gx);
+
+    // Accelerometer correction (skipped if accel is all zero, e.g. missing map)
+    const T aNorm2 = ax*ax + ay*ay + az*az;
+    const auto haveAccel = cmpGt(aNorm2, zero);
+    const T ra = one / sqrt(aNorm2);
+    ax = ax * ra; ay = ay * ra; az = az * ra;
+
+    const T _2q0 = two * q0, _2q1 = two * q1, _2q2 = two * q2, _2q3 = two * q3;
+    const T _4q0 = four * q0, _4q1 = four * q1, _4q2 = four * q2;
+    const T _8q1 = eight * q1, _8q2 = eight * q2;
+    const T q0q0 = q0 * q0, q1q1 = q1 * q1, q2q2 = q2 * q2, q3q3 = q3 * q3;
+
+    // Gradient of the gravity-direction objective
+    const T s0 = _4q0 * q2q2 + _2q2 * ax + _4q0 * q1q1 - _2q1 * ay;
+    const T s1 = _4q1 * q3q3 - _2q3 * ax + four * q0q0 * q1 - _2q0 * ay - _4q1
+               + _8q1 * q1q1 + _8q1 * q2q2 + _4q1 * az;
+    const T s2 = four * q0q0 * q2 + _2q0 * ax + _4q2 * q3q3 - _2q3 * ay - _4q2
+               + _8q2 * q1q1 + _8q2 * q2q2 + _4q2 * az;
+    const T s3 = four * q1q1 * q3 - _2q1 * ax + four * q2q2 * q3 - _2q2 * ay;
+
+    const T sNorm2 = s0*s0 + s1*s1 + s2*s2 + s3*s3;
+    const auto correct = haveAccel & cmpGt(sNorm2, zero);
+    const T rs = one / sqrt(sNorm2);
+    qDot0 = select(correct, qDot0 - beta * s0 * rs, qDot0);
+    qDot1 = select(correct, qDot1 - beta * s1 * rs, qDot1);
+    qDot2 = select(correct, qDot2 - beta * s2 * rs, qDot2);
+    qDot3 = select(correct, qDot3 - beta * s3 * rs, qDot3);
+
+    q0 = q0 + qDot0 * dt;
+    q1 = q1 + qDot1 * dt;
+    q2 = q2 + qDot2 * dt;
+    q3 = q3 + qDot3 * dt;
+
+    const T rq = one / sqrt(q0*q0 + q1*q1 + q2*q2 + q3*q3);
+    q0 = q0 * rq;
+    q1 = q1 * rq;
+    q2 = q2 * rq;
+    q3 = q3 * rq;
+}
@@ -0,0 +1,99 @@
+#include "AltitudeFilter.h"
+
+void AltitudeFilter::reset()
+{
+    for (int i = 0; i < 3; ++i) {
+        m_x[i] = 0.0;
+        for (int j = 0; j < 3; ++j) m_P[i][j] = 0.0;
+    }
+    m_haveTs = false;
+    m_init = false;
+}
+
+void AltitudeFilter::predict(double accelUpMps2, double dtSec)
+{
+    if (!m_init || dtSec <= 0.0) return;
+
+    const double dt = dtSec;
+    const double dt2 = 0.5 * dt * dt;
+
+    // Bias-corrected acceleration drives the kinematics
+    const double a = accelUpMps2 - m_x[2];
+    m_x[0] += m_x[1] * dt + a * dt2;
+    m_x[1] += a * dt;
+
+    // F = [1 dt -dt2; 0 1 -dt; 0 0 1]   P = F P F^T + Q
+    double (&P)[3][3] = m_P;
+    double FP[3][3];
+    for (int j = 0; j < 3; ++j) {
+        FP[0][j] = P[0][j] + dt * P[1][j] - dt2 * P[2][j];
+        FP[1][j] = P[1][j] - dt * P[2][j];
+        FP[2][j] = P[2][j];
+    }
+    for (int i = 0; i < 3; ++i) {
+        P[i][0] = FP[i][0] + dt * FP[i][1] - dt2 * FP[i][2];
+        P[i][1] = FP[i][1] - dt * FP[i][2];
+        P[i][2] = FP[i][2];
+    }
+
+    // Q: accel noise enters through G = [dt2, dt, 0], bias as a random walk
+    const double qa = m_accelSigma * m_accelSigma;
+    P[0][0] += dt2 * dt2 * qa;
+    P[0][1] += dt2 * dt  * qa;
+    P[1][0] += dt2 * dt  * qa;
+    P[1][1] += dt  * dt  * qa;
+    P[2][2] += m_biasSigma * m_biasSigma * dt;
+}
+
+void AltitudeFilter::correctBaro(double altM)
+{
+    if (!m_init) {
+        m_x[0] = altM;
+        m_x[1] = 0.0;
+        m_x[2] = 0.0;
+        for (int i = 0; i < 3; ++i)
+            for (int j = 0; j < 3; ++j) m_P[i][j] = 0.0;
+        m_P[0][0] = m_baroSigma * m_baroSigma;
+        m_P[1][1] = 4.0;     // unknown climb rate, +-2 m/s
+        m_P[2][2] = 0.25;    // unknown accel bias, +-0.5 m/s^2
+        m_init = true;
+        return;
+    }
+
+    // H = [1 0 0]
+    double (&P)[3][3] = m_P;
+    const double S = P[0][0] + m_baroSigma * m_baroSigma;
+    const double K0 = P[0][0] / S;
+    const double K1 = P[1][0] / S;
+    const double K2 = P[2][0] / S;
+
+    const double y = altM - m_x[0];
+    m_x[0] += K0 * y;
+    m_x[1] += K1 * y;
+    m_x[2] += K2 * y;
+
+    // P = (I - K H) P
+    const double r0[3] = { P[0][0], P[0][1], P[0][2] };
+    for (int j = 0; j < 3; ++j) {
+        P[0][j] -= K0 * r0[j];
+        P[1][j] -= K1 * r0[j];
+        P[2][j] -= K2 * r0[j];
+    }
+}
+
+void AltitudeFilter::update(long long tsUs, double accelUpMps2, bool haveBaro, double baroAltM)
+{
+    if (m_haveTs) {
+        const double dt = (tsUs - m_lastTsUs) * 1e-6;
+        if (dt > m_maxGapSec || dt < 0.0) {
+            // Dropout or clock jump: velocity is stale, start again from baro
+            m_init = false;
+        } else {
+            predict(accelUpMps2, dt);
+        }
+    }
+    m_lastTsUs = tsUs;
+    m_haveTs = true;
+
+    if (haveBaro) correctBaro(baroAltM);
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+// Baro + accelerometer Kalman filter for altitude and vertical speed.
+//
+// State is [altitude m, vertical speed m/s, accel bias m/s^2]. predict() runs
+// at the IMU rate with earth-frame vertical acceleration as the control input;
+// correctBaro() runs whenever a new baro altitude arrives. Everything is fixed
+// size (3x3), so each call is O(1) with no allocation.
+//
+// Without accel (OLED app, IMU missing) pass 0: it degrades to a constant-
+// velocity smoother of the baro altitude.
+
+class AltitudeFilter {
+public:
+    AltitudeFilter() = default;
+
+    // Noise tuning (1-sigma).
+    void setAccelNoise(double mps2)      { m_accelSigma = mps2; }   // vertical accel input
+    void setBaroNoise(double m)          { m_baroSigma = m; }       // baro altitude
+    void setBiasDrift(double mps2PerSqrtS) { m_biasSigma = mps2PerSqrtS; }
+
+    void reset();
+    bool isInitialized() const { return m_init; }
+
+    // Propagate by dtSec with upward linear acceleration (gravity removed).
+    void predict(double accelUpMps2, double dtSec);
+
+    // Fuse one baro altitude reading. The first call initializes the state.
+    void correctBaro(double altM);
+
+    // Convenience for timestamped streams: predict from the last timestamp,
+    // then correct if haveBaro. Long gaps re-seed from the next baro reading.
+    void update(long long tsUs, double accelUpMps2, bool haveBaro, double baroAltM);
+
+    double altitudeM() const  { return m_x[0]; }
+    double vspeedMps() const  { return m_x[1]; }
+    double accelBias() const  { return m_x[2]; }
+
+private:
+    double m_x[3] = {0, 0, 0};
+    double m_P[3][3] = {{0,0,0},{0,0,0},{0,0,0}};
+
+    double m_accelSigma = 0.35;
+    double m_baroSigma  = 0.8;
+    double m_biasSigma  = 0.02;
+    double m_maxGapSec  = 0.5;
+
+    long long m_lastTsUs = 0;
+    bool m_haveTs = false;
+    bool m_init = false;
+};
@@ -0,0 +1,53 @@
+#pragma once
+#include <cmath>
+#include "FastMath.h"
+
+// Attitude math shared by the live path (UartCborSource) and the offline
+// batch path (BatchFusion), so both produce identical numbers. Templated on
+// double / DVec like the AHRS kernel; trig comes from FastMath.h.
+
+// Euler angles (radians) from a unit quaternion, ZYX convention
+template <typename T> inline T quatRollRad(T q0, T q1, T q2, T q3)
+{
+    return fastAtan2(q0 * q1 + q2 * q3, T(0.5) - q1 * q1 - q2 * q2);
+}
+
+template <typename T> inline T quatPitchRad(T q0, T q1, T q2, T q3)
+{
+    T s = T(-2.0) * (q1 * q3 - q0 * q2);
+    s = select(cmpGt(s, T(1.0)), T(1.0), s);
+    s = select(cmpGt(T(-1.0), s), T(-1.0), s);
+    return fastAsin(s);
+}
+
+template <typename T> inline T quatYawRad(T q0, T q1, T q2, T q3)
+{
+    return fastAtan2(q1 * q2 + q0 * q3, T(0.5) - q2 * q2 - q3 * q3);
+}
+
+// Tilt-compensated magnetic heading -> true heading in [0, 360).
+// roll/pitch in radians; mx/my/mz as they come off the sensor (after any
+// hard/soft-iron correction).
+template <typename T>
+inline T tiltCompensatedHeadingDeg(T roll, T pitch,
+                                   T sensorMx, T sensorMy, T sensorMz,
+                                   T declinationDeg)
+{
+    // NOTE: Axis convention depends on your physical mounting.
+    // The magnetometer axes are swapped/flipped relative to the IMU here.
+    // Normalize mag is optional; we just use ratios.
+    const T mx = sensorMy;
+    const T my = sensorMx;
+    const T mz = -sensorMz;
+
+    T cr, sr, cp, sp;
+    fastSinCos(roll, sr, cr);
+    fastSinCos(pitch, sp, cp);
+
+    const T Xh = mx*cp + mz*sp;
+    const T Yh = mx*sr*sp + my*cr - mz*sr*cp;
+
+    // If it appears mirrored, flip sign of the atan2 result.
+    // Magnetic -> true, then wrap
+    return fastWrap360(fastAtan2(Yh, Xh) * T(180.0 / M_PI) + declinationDeg);
+}
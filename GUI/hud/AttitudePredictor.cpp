@@ -0,0 +1,165 @@
+#include "AttitudePredictor.h"
+#include "FastMath.h"
+
+#include "SteadyClock.h"
+
+#include <cmath>
+
+static constexpr double kRadToDeg = 180.0 / M_PI;
+
+static double wrap180(double deg)
+{
+    return fastWrap360(deg + 180.0) - 180.0;
+}
+
+long long AttitudePredictor::steadyNowUs()
+{
+    return ::steadyNowUs();
+}
+
+void AttitudePredictor::addSample(const HudSample& s, long long hostUs)
+{
+    const long long devUs = s.tsUs ? s.tsUs : hostUs;
+
+    // Buffering delay relative to the fastest sample seen. The minimum leaks
+    // upward at 100 ppm so ESP32/Pi clock drift can't pin it to a stale value.
+    const long long offset = hostUs - devUs;
+    if (m_haveOffset && m_have) m_minOffsetUs += (devUs - m_lastDevUs) / 10000;
+    if (!m_haveOffset || offset < m_minOffsetUs) {
+        m_minOffsetUs = offset;
+        m_haveOffset = true;
+    }
+    m_bufferDelayUs = offset - m_minOffsetUs;
+
+    Attitude a;
+    a.rollDeg = s.rollDeg;
+    a.pitchDeg = s.pitchDeg;
+    a.headingDeg = s.headingDeg;
+
+    if (m_statsEnabled) scorePending(devUs, a);
+
+    const double dt = m_have ? (devUs - m_lastDevUs) * 1e-6 : 0.0;
+    const bool haveGyro = (s.gx != 0.0 || s.gy != 0.0 || s.gz != 0.0);
+    const double dHeading = m_have ? wrap180(a.headingDeg - m_last.headingDeg) : 0.0;
+
+    if (haveGyro) {
+        // Body rates -> ZYX euler rates
+        const double phi = s.rollDeg / kRadToDeg;
+        const double theta = s.pitchDeg / kRadToDeg;
+        const double sphi = std::sin(phi), cphi = std::cos(phi);
+        double cth = std::cos(theta);
+        if (std::fabs(cth) < 0.05) cth = (cth < 0 ? -0.05 : 0.05);   // near +-90 pitch
+        const double tth = std::sin(theta) / cth;
+
+        m_rollRate  = (s.gx + sphi * tth * s.gy + cphi * tth * s.gz) * kRadToDeg;
+        m_pitchRate = (cphi * s.gy - sphi * s.gz) * kRadToDeg;
+        const double yawRate = (sphi / cth * s.gy + cphi / cth * s.gz) * kRadToDeg;
+
+        // Learn whether heading increases with gyro yaw or against it
+        if (dt > 0.0 && dt < 0.2) {
+            m_yawSignCorr = 0.98 * m_yawSignCorr + 0.02 * (yawRate * dHeading / dt);
+        }
+        const double sign = (m_yawSignCorr > 1.0) ? 1.0 : (m_yawSignCorr < -1.0 ? -1.0 : 0.0);
+        m_yawRate = sign * yawRate;
+    } else if (dt > 0.0 && dt < 0.2) {
+        const double k = 0.3;
+        m_rollRate  += k * ((a.rollDeg - m_last.rollDeg) / dt - m_rollRate);
+        m_pitchRate += k * ((a.pitchDeg - m_last.pitchDeg) / dt - m_pitchRate);
+        m_yawRate   += k * (dHeading / dt - m_yawRate);
+    } else {
+        m_rollRate = m_pitchRate = m_yawRate = 0.0;
+    }
+
+    m_last = a;
+    m_lastDevUs = devUs;
+    m_lastHostUs = hostUs;
+    m_have = true;
+}
+
+AttitudePredictor::Attitude AttitudePredictor::extrapolate(long long renderHostUs, long long& horizonUs) const
+{
+    const long long photonHostUs = renderHostUs + m_displayLatencyUs;
+    horizonUs = (photonHostUs - m_lastHostUs) + m_bufferDelayUs + m_inputLatencyUs;
+    if (horizonUs < 0) horizonUs = 0;
+    if (horizonUs > m_maxHorizonUs) horizonUs = m_maxHorizonUs;
+
+    const double h = horizonUs * 1e-6;
+    Attitude out;
+    out.rollDeg = wrap180(m_last.rollDeg + m_rollRate * h);
+    out.pitchDeg = m_last.pitchDeg + m_pitchRate * h;
+    if (out.pitchDeg > 90.0) out.pitchDeg = 90.0;
+    if (out.pitchDeg < -90.0) out.pitchDeg = -90.0;
+    out.headingDeg = wrap180(m_last.headingDeg + m_yawRate * h - 180.0) + 180.0;
+    return out;
+}
+
+AttitudePredictor::Attitude AttitudePredictor::peek(long long renderHostUs) const
+{
+    if (!m_have || !m_enabled) return m_last;
+    long long horizonUs = 0;
+    return extrapolate(renderHostUs, horizonUs);
+}
+
+AttitudePredictor::Attitude AttitudePredictor::predict(long long renderHostUs)
+{
+    if (!m_have || !m_enabled) return m_last;
+    long long horizonUs = 0;
+    const Attitude out = extrapolate(renderHostUs, horizonUs);
+
+    if (m_statsEnabled) {
+        // Overwrite the oldest entry when full
+        const int idx = (m_pendHead + m_pendCount) % kPending;
+        m_pending[idx] = Pending{ m_lastDevUs + horizonUs, out, m_last };
+        if (m_pendCount < kPending) m_pendCount++;
+        else m_pendHead = (m_pendHead + 1) % kPending;
+
+        m_sumLatencyUs += double(horizonUs);
+        m_latencyCount++;
+    }
+    return out;
+}
+
+void AttitudePredictor::scorePending(long long devUs, const Attitude& actual)
+{
+    while (m_pendCount > 0) {
+        const Pending& p = m_pending[m_pendHead];
+        if (p.targetDevUs > devUs) break;
+
+        const double ep[3] = { wrap180(p.predicted.rollDeg - actual.rollDeg),
+                               p.predicted.pitchDeg - actual.pitchDeg,
+                               wrap180(p.predicted.headingDeg - actual.headingDeg) };
+        const double eh[3] = { wrap180(p.held.rollDeg - actual.rollDeg),
+                               p.held.pitchDeg - actual.pitchDeg,
+                               wrap180(p.held.headingDeg - actual.headingDeg) };
+        for (int i = 0; i < 3; ++i) {
+            m_sumPred[i] += ep[i] * ep[i];
+            m_sumHold[i] += eh[i] * eh[i];
+        }
+        m_statCount++;
+
+        m_pendHead = (m_pendHead + 1) % kPending;
+        m_pendCount--;
+    }
+}
+
+AttitudePredictor::Stats AttitudePredictor::takeStats()
+{
+    Stats st;
+    st.count = m_statCount;
+    if (m_statCount > 0) {
+        const double n = double(m_statCount);
+        st.rmsPredRollDeg    = std::sqrt(m_sumPred[0] / n);
+        st.rmsPredPitchDeg   = std::sqrt(m_sumPred[1] / n);
+        st.rmsPredHeadingDeg = std::sqrt(m_sumPred[2] / n);
+        st.rmsHoldRollDeg    = std::sqrt(m_sumHold[0] / n);
+        st.rmsHoldPitchDeg   = std::sqrt(m_sumHold[1] / n);
+        st.rmsHoldHeadingDeg = std::sqrt(m_sumHold[2] / n);
+    }
+    if (m_latencyCount > 0) st.meanLatencyMs = m_sumLatencyUs / double(m_latencyCount) / 1000.0;
+
+    m_statCount = 0;
+    m_latencyCount = 0;
+    m_sumLatencyUs = 0;
+    for (int i = 0; i < 3; ++i) m_sumPred[i] = m_sumHold[i] = 0.0;
+    return st;
+}
@@ -0,0 +1,99 @@
+#pragma once
+#include "HudSample.h"
+
+// Extrapolates roll / pitch / heading from the newest sample to the moment the
+// frame is expected to be on screen ("photon time").
+//
+// Latency = fixed input latency (UART transmit time, configured)
+//         + measured buffering delay of this sample (arrival - device ts,
+//           relative to the smallest value seen)
+//         + time since arrival + display latency (configured).
+//
+// Euler rates come from the gyro (body rates -> ZYX euler rates). Without gyro
+// data (dummy source, DEV lines) they fall back to smoothed finite differences.
+// The extrapolation horizon is clamped so a stale sample can't fling the horizon.
+//
+// Stats mode records each prediction and scores it against the first real
+// sample at or after its target time, next to the error of just holding the
+// last value.
+
+class AttitudePredictor {
+public:
+    struct Attitude {
+        double rollDeg = 0;
+        double pitchDeg = 0;
+        double headingDeg = 0;
+    };
+
+    struct Stats {
+        long long count = 0;
+        double rmsPredRollDeg = 0, rmsPredPitchDeg = 0, rmsPredHeadingDeg = 0;
+        double rmsHoldRollDeg = 0, rmsHoldPitchDeg = 0, rmsHoldHeadingDeg = 0;
+        double meanLatencyMs = 0;
+    };
+
+    void setEnabled(bool on)               { m_enabled = on; }
+    void setMaxHorizonUs(long long us)     { m_maxHorizonUs = us; }
+    void setInputLatencyUs(long long us)   { m_inputLatencyUs = us; }
+    void setDisplayLatencyUs(long long us) { m_displayLatencyUs = us; }
+    void setStatsEnabled(bool on)          { m_statsEnabled = on; }
+
+    bool isEnabled() const { return m_enabled; }
+    bool hasSample() const { return m_have; }
+
+    // hostUs: arrival time on steadyNowUs()'s clock.
+    void addSample(const HudSample& s, long long hostUs);
+
+    // Attitude expected at photon time for a frame rendered at renderHostUs.
+    // Call it for frames that are actually displayed: in stats mode each
+    // call is recorded and scored.
+    Attitude predict(long long renderHostUs);
+    // Same result, nothing recorded (change detection, look-ahead)
+    Attitude peek(long long renderHostUs) const;
+
+    // Snapshot and clear the accumulated stats.
+    Stats takeStats();
+
+    static long long steadyNowUs();
+
+private:
+    struct Pending {
+        long long targetDevUs;
+        Attitude predicted;
+        Attitude held;
+    };
+
+    Attitude extrapolate(long long renderHostUs, long long& horizonUs) const;
+    void scorePending(long long devUs, const Attitude& actual);
+
+    bool m_enabled = true;
+    bool m_statsEnabled = false;
+    long long m_maxHorizonUs = 50000;
+    long long m_inputLatencyUs = 10000;
+    long long m_displayLatencyUs = 16667;
+
+    // Latest sample
+    bool m_have = false;
+    Attitude m_last;
+    double m_rollRate = 0, m_pitchRate = 0, m_yawRate = 0;   // deg/s
+    long long m_lastDevUs = 0;
+    long long m_lastHostUs = 0;
+    long long m_bufferDelayUs = 0;
+
+    // Device -> host offset; the minimum is the least-buffered sample seen
+    long long m_minOffsetUs = 0;
+    bool m_haveOffset = false;
+
+    // Mag heading and gyro yaw may disagree in sign (mounting); learned online
+    double m_yawSignCorr = 0;
+
+    // Stats
+    static constexpr int kPending = 64;
+    Pending m_pending[kPending];
+    int m_pendHead = 0, m_pendCount = 0;
+    long long m_statCount = 0;
+    double m_sumPred[3] = {0, 0, 0};
+    double m_sumHold[3] = {0, 0, 0};
+    double m_sumLatencyUs = 0;
+    long long m_latencyCount = 0;
+};
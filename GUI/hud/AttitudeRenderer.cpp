@@ -0,0 +1,161 @@
+#include "AttitudeRenderer.h"
+#include "HudStyle.h"
+
+#include <QPainter>
+#include <QtMath>
+
+void AttitudeRenderer::configure(const QSizeF& circle, qreal dpr, const QFont& ladderFont)
+{
+    if (circle == m_size && dpr == m_dpr && ladderFont == m_font && !m_sprite.isNull())
+        return;
+
+    m_size = circle;
+    m_dpr = dpr;
+    m_font = ladderFont;
+    renderSprite();
+    renderMask();
+
+    const QSize px(qMax(1, qRound(circle.width() * dpr)), qMax(1, qRound(circle.height() * dpr)));
+    m_scratch = QImage(px, QImage::Format_ARGB32_Premultiplied);
+    m_scratch.setDevicePixelRatio(dpr);
+}
+
+AttitudeRenderer::SpriteGeometry AttitudeRenderer::spriteGeometry(const QSizeF& circle)
+{
+    SpriteGeometry g;
+    // Map pitch degrees to pixels; ~30° visible vertically
+    g.pxPerDeg = circle.height() / 30.0;
+
+    // Wide/tall enough that the circle stays covered at any roll and at
+    // +-90 deg pitch
+    const double diameter = qMax(circle.width(), circle.height()) + 4.0;
+    const double margin = diameter / 2.0;
+    g.width = diameter;
+    g.height = 2.0 * margin + 180.0 * g.pxPerDeg;
+    g.horizonY = margin + 90.0 * g.pxPerDeg;
+    return g;
+}
+
+void AttitudeRenderer::renderSprite()
+{
+    const SpriteGeometry g = spriteGeometry(m_size);
+    m_pxPerDeg = g.pxPerDeg;
+    m_horizonY = g.horizonY;
+
+    m_sprite = QImage(qCeil(g.width * m_dpr), qCeil(g.height * m_dpr), QImage::Format_ARGB32_Premultiplied);
+    m_sprite.setDevicePixelRatio(m_dpr);
+
+    QPainter p(&m_sprite);
+    p.setRenderHint(QPainter::Antialiasing, true);
+    p.setRenderHint(QPainter::TextAntialiasing, true);
+    p.setFont(m_font);
+    paintSprite(p, m_size);
+}
+
+void AttitudeRenderer::paintSprite(QPainter& p, const QSizeF& circle)
+{
+    const SpriteGeometry g = spriteGeometry(circle);
+    const double w = g.width, h = g.height, horizonY = g.horizonY;
+
+    // Draw "sky" and "ground"
+    p.fillRect(QRectF(0, 0, w, horizonY), QColor(20, 80, 140));           // blue
+    p.fillRect(QRectF(0, horizonY, w, h - horizonY), QColor(45, 45, 45)); // dark gray
+
+    // Horizon line
+    p.setPen(hudPen(3.0));
+    p.drawLine(QPointF(0, horizonY), QPointF(w, horizonY));
+
+    // Pitch ladder lines every 5 degrees (above and below horizon)
+    p.setPen(hudPen(2.0));
+    const double cx = w / 2.0;
+
+    for (int deg = -30; deg <= 30; deg += 5) {
+        if (deg == 0) continue;
+        const double y = horizonY - (deg * g.pxPerDeg);
+
+        const double halfLen = (qAbs(deg) % 10 == 0) ? circle.width()*0.22 : circle.width()*0.16;
+        const QPointF L(cx - halfLen, y);
+        const QPointF R(cx + halfLen, y);
+        p.drawLine(L, R);
+
+        // Labels for 10-degree marks
+        if (qAbs(deg) % 10 == 0) {
+            const QString t = QString::number(qAbs(deg));
+            p.drawText(QRectF(L.x() - 30, y - 10, 28, 20), Qt::AlignRight | Qt::AlignVCenter, t);
+            p.drawText(QRectF(R.x() + 2, y - 10, 28, 20), Qt::AlignLeft  | Qt::AlignVCenter, t);
+        }
+    }
+}
+
+void AttitudeRenderer::paintReference(QPainter& p, const QRectF& circle)
+{
+    p.save();
+    p.setPen(hudPen(2.0));
+    p.setBrush(Qt::NoBrush);
+
+    // Circle outline
+    p.drawEllipse(circle);
+
+    // Center little reference marker (fixed, not rolling)
+    p.setPen(hudPen(2.5));
+    const QPointF c = circle.center();
+    p.drawLine(QPointF(c.x() - circle.width()*0.10, c.y()),
+               QPointF(c.x() - circle.width()*0.02, c.y()));
+    p.drawLine(QPointF(c.x() + circle.width()*0.02, c.y()),
+               QPointF(c.x() + circle.width()*0.10, c.y()));
+    p.drawLine(QPointF(c.x(), c.y() - circle.height()*0.02),
+               QPointF(c.x(), c.y() + circle.height()*0.02));
+
+    p.restore();
+}
+
+void AttitudeRenderer::renderMask()
+{
+    const QSize px(qMax(1, qRound(m_size.width() * m_dpr)), qMax(1, qRound(m_size.height() * m_dpr)));
+    m_mask = QImage(px, QImage::Format_ARGB32_Premultiplied);
+    m_mask.setDevicePixelRatio(m_dpr);
+    m_mask.fill(Qt::transparent);
+
+    QPainter p(&m_mask);
+    p.setRenderHint(QPainter::Antialiasing, true);
+    p.setPen(Qt::NoPen);
+    p.setBrush(Qt::white);
+    p.drawEllipse(QRectF(QPointF(0, 0), m_size));
+}
+
+qint64 AttitudeRenderer::pitchOffsetPx(double pitchDeg) const
+{
+    return qRound64(qBound(-90.0, pitchDeg, 90.0) * m_pxPerDeg * m_dpr);
+}
+
+qint64 AttitudeRenderer::rollStep(double rollDeg) const
+{
+    const double rimPx = 0.5 * qMax(m_size.width(), m_size.height()) * m_dpr;
+    return qRound64(qDegreesToRadians(rollDeg) * rimPx);
+}
+
+void AttitudeRenderer::draw(QPainter& p, const QRectF& circle, double rollDeg, double pitchDeg)
+{
+    if (m_sprite.isNull()) return;
+
+    const double pitch = qBound(-90.0, pitchDeg, 90.0);
+
+    QPainter sp(&m_scratch);
+    sp.setRenderHint(QPainter::SmoothPixmapTransform, m_smooth);
+    sp.setCompositionMode(QPainter::CompositionMode_Source);
+
+    // Roll around the center; the sprite line at -pitch lands on the center
+    // (positive pitch moves the horizon up, as before)
+    sp.translate(m_size.width() / 2.0, m_size.height() / 2.0);
+    sp.rotate(-rollDeg); // negative to match typical aircraft convention
+    sp.drawImage(QPointF(-m_sprite.width() / (2.0 * m_dpr), -(m_horizonY + pitch * m_pxPerDeg)),
+                 m_sprite);
+
+    // Cut to the circle
+    sp.resetTransform();
+    sp.setCompositionMode(QPainter::CompositionMode_DestinationIn);
+    sp.drawImage(0, 0, m_mask);
+    sp.end();
+
+    p.drawImage(circle.topLeft(), m_scratch);
+}
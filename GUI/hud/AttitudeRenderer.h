@@ -0,0 +1,59 @@
+#pragma once
+#include <QFont>
+#include <QImage>
+#include <QRectF>
+
+class QPainter;
+
+// Attitude ball without per-frame path clipping or ladder stroking.
+//
+// The sky/ground fill, horizon and pitch ladder are pre-rendered into one
+// tall sprite covering +-90 deg of pitch (plus a half-circle margin), and
+// the instrument outline into an antialiased alpha mask. A frame is one
+// rotated/translated blit of the sprite into a circle-sized scratch image,
+// one DestinationIn composite with the mask, and one blit to the target.
+// Everything is a QImage, so draw() may run on a worker thread.
+class AttitudeRenderer
+{
+public:
+    // Sprite layout for a given circle size (logical px); shared with the
+    // QtQuick renderer
+    struct SpriteGeometry {
+        double width = 0.0, height = 0.0;
+        double horizonY = 0.0;   // y of the 0 deg line
+        double pxPerDeg = 0.0;
+    };
+    static SpriteGeometry spriteGeometry(const QSizeF& circle);
+    static void paintSprite(QPainter& p, const QSizeF& circle);   // uses the painter's font
+
+    // Circle outline and the fixed aircraft reference marker (drawn over
+    // the moving sprite)
+    static void paintReference(QPainter& p, const QRectF& circle);
+
+    // Cheap when nothing changed; re-renders sprite and mask otherwise
+    void configure(const QSizeF& circle, qreal dpr, const QFont& ladderFont);
+    void draw(QPainter& p, const QRectF& circle, double rollDeg, double pitchDeg);
+
+    // Bilinear filtering of the rotated sprite (off = nearest, cheaper)
+    void setSmoothTransform(bool on) { m_smooth = on; }
+
+    // Rendered quanta: device-pixel sprite offset for pitch, and roll in
+    // steps that move the circle's rim by one device pixel
+    qint64 pitchOffsetPx(double pitchDeg) const;
+    qint64 rollStep(double rollDeg) const;
+
+private:
+    QSizeF  m_size;
+    qreal   m_dpr = 0.0;
+    QFont   m_font;
+
+    QImage  m_sprite;
+    double  m_pxPerDeg = 0.0;   // logical px per degree of pitch
+    double  m_horizonY = 0.0;   // sprite y of the 0 deg line (logical)
+    QImage  m_mask;             // alpha of the circle, device pixels
+    QImage  m_scratch;
+    bool    m_smooth = true;
+
+    void renderSprite();
+    void renderMask();
+};
@@ -0,0 +1,129 @@
+#include "BatchFusion.h"
+#include "AhrsFilter.h"
+#include "AhrsKernel.h"
+#include "AttitudeMath.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+static constexpr int N = DVec::N;
+
+int batchFusionLanes()
+{
+    return N;
+}
+
+// One group of up to N jobs in lockstep
+static void runGroup(BatchJob* jobs, int lanes)
+{
+    AhrsFilter f[N];
+    size_t longest = 0;
+    for (int l = 0; l < lanes; ++l) {
+        f[l].setBeta(jobs[l].beta);
+        longest = std::max(longest, jobs[l].in.count);
+    }
+
+    alignas(32) double q[4][N], g[3][N], a[3][N], dt[N], beta[N];
+    bool step[N];
+
+    for (size_t i = 0; i < longest; ++i) {
+        // Gather: per-lane clock handling is scalar (it may re-seed)
+        for (int l = 0; l < N; ++l) {
+            step[l] = false;
+            dt[l] = 0.0;
+            beta[l] = 0.0;
+            g[0][l] = g[1][l] = g[2][l] = 0.0;
+            a[0][l] = a[1][l] = a[2][l] = 0.0;
+            q[0][l] = 1.0; q[1][l] = q[2][l] = q[3][l] = 0.0;
+            if (l >= lanes || i >= jobs[l].in.count) continue;
+
+            const SensorColumns& in = jobs[l].in;
+            const double d = f[l].advanceClock(in.tsUs[i], in.ax[i], in.ay[i], in.az[i]);
+            if (d <= 0.0) continue;
+
+            step[l] = true;
+            dt[l] = d;
+            beta[l] = f[l].beta();
+            g[0][l] = in.gx[i]; g[1][l] = in.gy[i]; g[2][l] = in.gz[i];
+            a[0][l] = in.ax[i]; a[1][l] = in.ay[i]; a[2][l] = in.az[i];
+            q[0][l] = f[l].q0(); q[1][l] = f[l].q1(); q[2][l] = f[l].q2(); q[3][l] = f[l].q3();
+        }
+
+        // Vector step across all lanes
+        DVec q0 = DVec::load(q[0]), q1 = DVec::load(q[1]);
+        DVec q2 = DVec::load(q[2]), q3 = DVec::load(q[3]);
+        madgwickImuStep(q0, q1, q2, q3,
+                        DVec::load(g[0]), DVec::load(g[1]), DVec::load(g[2]),
+                        DVec::load(a[0]), DVec::load(a[1]), DVec::load(a[2]),
+                        DVec::load(beta), DVec::load(dt));
+        q0.store(q[0]); q1.store(q[1]); q2.store(q[2]); q3.store(q[3]);
+
+        // Scatter; gather the per-lane magnetometer (calibration is scalar)
+        alignas(32) double m[3][N] = {}, decl[N] = {};
+        for (int l = 0; l < lanes; ++l) {
+            const BatchJob& job = jobs[l];
+            if (i >= job.in.count) continue;
+            if (step[l]) f[l].setQuaternion(q[0][l], q[1][l], q[2][l], q[3][l]);
+            q[0][l] = f[l].q0(); q[1][l] = f[l].q1(); q[2][l] = f[l].q2(); q[3][l] = f[l].q3();
+
+            if (job.out.headingDeg && job.in.mx) {
+                m[0][l] = job.in.mx[i]; m[1][l] = job.in.my[i]; m[2][l] = job.in.mz[i];
+                if (job.magCal.valid) job.magCal.apply(m[0][l], m[1][l], m[2][l]);
+                decl[l] = job.declinationDeg;
+            }
+        }
+
+        // Vector euler + heading
+        q0 = DVec::load(q[0]); q1 = DVec::load(q[1]);
+        q2 = DVec::load(q[2]); q3 = DVec::load(q[3]);
+        const DVec roll = quatRollRad(q0, q1, q2, q3);
+        const DVec pitch = quatPitchRad(q0, q1, q2, q3);
+        const DVec heading = tiltCompensatedHeadingDeg(roll, pitch,
+                                                       DVec::load(m[0]), DVec::load(m[1]),
+                                                       DVec::load(m[2]), DVec::load(decl));
+        alignas(32) double rollDeg[N], pitchDeg[N], headingDeg[N];
+        (roll * DVec(180.0 / M_PI)).store(rollDeg);
+        (pitch * DVec(180.0 / M_PI)).store(pitchDeg);
+        heading.store(headingDeg);
+
+        for (int l = 0; l < lanes; ++l) {
+            BatchJob& job = jobs[l];
+            if (i >= job.in.count) continue;
+
+            AttitudeColumns& out = job.out;
+            if (!f[l].isInitialized()) {
+                out.rollDeg[i] = out.pitchDeg[i] = 0.0;
+                if (out.headingDeg) out.headingDeg[i] = 0.0;
+                continue;
+            }
+            out.rollDeg[i]  = rollDeg[l];
+            out.pitchDeg[i] = pitchDeg[l];
+            if (out.headingDeg && job.in.mx) out.headingDeg[i] = headingDeg[l];
+        }
+    }
+}
+
+void runBatchFusion(BatchJob* jobs, size_t jobCount, unsigned threads)
+{
+    const size_t groups = (jobCount + N - 1) / N;
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = (unsigned)std::min<size_t>(threads, groups);
+
+    std::atomic<size_t> next{0};
+    auto worker = [&]() {
+        for (size_t gi; (gi = next.fetch_add(1)) < groups; ) {
+            const size_t first = gi * N;
+            runGroup(jobs + first, (int)std::min<size_t>(N, jobCount - first));
+        }
+    };
+
+    if (threads <= 1) {
+        worker();
+        return;
+    }
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < threads; ++t) pool.emplace_back(worker);
+    for (std::thread& t : pool) t.join();
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <cstddef>
+#include "MagCalibration.h"
+
+// Offline attitude reprocessing over structure-of-arrays sensor columns.
+//
+// Each job is one flight log with one parameter set (AHRS beta, declination,
+// mag calibration). Jobs are packed DVec::N to a group and stepped in
+// lockstep, one SIMD lane per job, through the same Madgwick kernel the live
+// AhrsFilter uses. Timestamp handling, euler extraction and heading go
+// through the very same scalar code, so every output is bit-identical to
+// the live AHRS / computeAttitudeFallback path fed the same inputs. The
+// columns are taken as already filtered: UartCborSource runs SampleFilter
+// (Hampel on accel/gyro/mag by default) before fusion and this does not, so
+// raw logs match the live output only with --filter none.
+//
+// A gain sweep is just N jobs pointing at the same input columns.
+
+struct SensorColumns {
+    const long long* tsUs = nullptr;
+    const double* gx = nullptr; const double* gy = nullptr; const double* gz = nullptr;
+    const double* ax = nullptr; const double* ay = nullptr; const double* az = nullptr;
+    const double* mx = nullptr; const double* my = nullptr; const double* mz = nullptr;
+    size_t count = 0;
+};
+
+struct AttitudeColumns {
+    double* rollDeg = nullptr;
+    double* pitchDeg = nullptr;
+    double* headingDeg = nullptr;   // may be null if mag columns are absent
+};
+
+struct BatchJob {
+    SensorColumns   in;
+    AttitudeColumns out;
+    double beta = 0.1;
+    double declinationDeg = -6.3;
+    MagCalibration magCal;          // applied if valid
+};
+
+// Runs all jobs; groups of DVec::N jobs are spread over `threads` worker
+// threads (0 = hardware concurrency). Samples before the filter has seeded
+// are written as 0, like a live frame with no euler.
+void runBatchFusion(BatchJob* jobs, size_t jobCount, unsigned threads = 0);
+
+// Number of jobs stepped together (SIMD width in doubles).
+int batchFusionLanes();
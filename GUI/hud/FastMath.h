@@ -0,0 +1,151 @@
+#pragma once
+#include <cmath>
+#include "SimdLanes.h"
+
+// Fast, accuracy-bounded replacements for the libm calls on the per-sample
+// and render paths. Every function is a template over double and DVec
+// (SSE2 / AVX / NEON, see SimdLanes.h): the same operation sequence runs in
+// both, so the SIMD variants are bit-identical to the scalar ones. All
+// branches are select()s; no lookup tables.
+//
+// Maximum absolute error against libm (checked by fastmath_bench):
+//   fastAtan2   < 4e-8 rad  (2.2e-6 deg), any quadrant
+//   fastAsin    < 5e-8 rad  for |s| <= 1
+//   fastSinCos  < 1e-15     for |x| <= 1e4 rad (Cody-Waite reduction)
+//   fastWrap360 exact for |deg| < 2^51 (result in [0, 360))
+//   fastPressureAltitudeM  < 6 mm for 0.4 <= p/p0 <= 1.15
+//     (about -1.1 km .. +7.2 km around the reference), libm outside that.
+//
+// Signed zeros are not preserved (atan2(-0, x) returns +0).
+
+namespace fm {
+
+template <typename T> inline T absT(T x) { return select(cmpGt(T(0.0), x), -x, x); }
+
+// Round to nearest integer (ties to even) with two additions; |x| < 2^51.
+template <typename T> inline T roundT(T x)
+{
+    const T magic(6755399441055744.0);   // 1.5 * 2^52
+    return (x + magic) - magic;
+}
+
+template <typename T> inline T floorT(T x)
+{
+    const T r = roundT(x);
+    return select(cmpGt(r, x), r - T(1.0), r);
+}
+
+// atan(a) for a in [0, 1]: a * P(a^2), degree-7 minimax in a^2
+template <typename T> inline T atanUnit(T a)
+{
+    const T t = a * a;
+    T p(-0.004054175079982529);
+    p = p * t + T( 0.021861481548237513);
+    p = p * t + T(-0.05591009968656323);
+    p = p * t + T( 0.09642025863016908);
+    p = p * t + T(-0.1390855865457225);
+    p = p * t + T( 0.19946550549965258);
+    p = p * t + T(-0.33329859359806924);
+    p = p * t + T( 0.9999993351881914);
+    return a * p;
+}
+
+} // namespace fm
+
+template <typename T> inline T fastAtan2(T y, T x)
+{
+    const T zero(0.0);
+    const T ax = fm::absT(x), ay = fm::absT(y);
+
+    // Reduce to a ratio in [0, 1]
+    const auto swap = cmpGt(ay, ax);
+    const T num = select(swap, ax, ay);
+    const T den = select(swap, ay, ax);
+    const T a = select(cmpGt(den, zero), num / den, zero);   // atan2(0, 0) = 0
+
+    T r = fm::atanUnit(a);
+    r = select(swap, T(M_PI_2) - r, r);
+    r = select(cmpGt(zero, x), T(M_PI) - r, r);
+    r = select(cmpGt(zero, y), -r, r);
+    return r;
+}
+
+// asin(s), s in [-1, 1]
+template <typename T> inline T fastAsin(T s)
+{
+    using std::sqrt;
+    const T one(1.0);
+    return fastAtan2(s, sqrt((one - s) * (one + s)));
+}
+
+template <typename T> inline void fastSinCos(T x, T& s, T& c)
+{
+    // x = k * pi/2 + r, |r| <= pi/4; pi/2 split so k * PIO2_HI is exact
+    const T PIO2_HI(1.57079632673412561417e+00);
+    const T PIO2_LO(6.07710050650619224932e-11);
+    const T k = fm::roundT(x * T(M_2_PI));
+    const T r = (x - k * PIO2_HI) - k * PIO2_LO;
+    const T r2 = r * r;
+
+    // Taylor to r^15 / r^16: truncation < 1e-16 on |r| <= pi/4
+    T ps(-1.0 / 1307674368000.0);
+    ps = ps * r2 + T(1.0 / 6227020800.0);
+    ps = ps * r2 - T(1.0 / 39916800.0);
+    ps = ps * r2 + T(1.0 / 362880.0);
+    ps = ps * r2 - T(1.0 / 5040.0);
+    ps = ps * r2 + T(1.0 / 120.0);
+    ps = ps * r2 - T(1.0 / 6.0);
+    const T sr = r + r * r2 * ps;
+
+    T pc(1.0 / 20922789888000.0);
+    pc = pc * r2 - T(1.0 / 87178291200.0);
+    pc = pc * r2 + T(1.0 / 479001600.0);
+    pc = pc * r2 - T(1.0 / 3628800.0);
+    pc = pc * r2 + T(1.0 / 40320.0);
+    pc = pc * r2 - T(1.0 / 720.0);
+    pc = pc * r2 + T(1.0 / 24.0);
+    pc = pc * r2 - T(0.5);
+    const T cr = T(1.0) + r2 * pc;
+
+    // Quadrant q = k mod 4: sin = s, c, -s, -c ; cos = c, -s, -c, s
+    const T q = k - T(4.0) * fm::floorT(k * T(0.25));
+    const auto hi = cmpGt(q, T(1.5));                    // q in {2, 3}
+    const auto odd = cmpGt(select(hi, q - T(2.0), q), T(0.5));
+
+    const T sv = select(odd, cr, sr);
+    const T cv = select(odd, -sr, cr);
+    s = select(hi, -sv, sv);
+    c = select(hi, -cv, cv);
+}
+
+template <typename T> inline T fastWrap360(T deg)
+{
+    T w = deg - T(360.0) * fm::floorT(deg * T(1.0 / 360.0));
+    w = select(cmpGt(T(0.0), w), w + T(360.0), w);        // deg / 360 rounded up to the integer
+    return select(cmpGt(T(360.0), w), w, w - T(360.0));   // guard rounding to 360 (also w + 360)
+}
+
+// Barometric altitude in metres: 44330 * (1 - (p/p0)^0.1903).
+// Degree-8 minimax in u = p/p0 - 1 over the documented range; the scalar
+// overload falls back to pow() outside it.
+template <typename T> inline T fastPressureAltitudePoly(T ratio)
+{
+    const T u = ratio - T(1.0);
+    T a(7878.999761164638);
+    a = a * u + T( 7797.788206732485);
+    a = a * u + T( 4487.9117205757375);
+    a = a * u + T(-704.0316303706779);
+    a = a * u + T( 1347.8382125033102);
+    a = a * u + T(-2080.2158096271173);
+    a = a * u + T( 3415.8980914433855);
+    a = a * u + T(-8435.844692720604);
+    a = a * u + T(-0.0009400578023814881);
+    return a;
+}
+
+inline double fastPressureAltitudeM(double p, double p0)
+{
+    const double ratio = p / p0;
+    if (ratio < 0.4 || ratio > 1.15) return 44330.0 * (1.0 - std::pow(ratio, 0.1903));
+    return fastPressureAltitudePoly(ratio);
+}
@@ -0,0 +1,290 @@
+#include "FrameRecorder.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+// Headers are written as they are in memory (all supported targets are
+// little-endian)
+static_assert(sizeof(FrameRecorder::FrameHeader) == 48, "FrameHeader layout");
+static_assert(sizeof(FrameRecorder::RectHeader) == 20, "RectHeader layout");
+
+static const char kFileMagic[8] = { 'H', 'U', 'D', 'R', 'E', 'C', '1', '\0' };
+
+template <typename T>
+static void put(std::vector<uint8_t>& out, const T& v)
+{
+    const size_t at = out.size();
+    out.resize(at + sizeof(T));
+    std::memcpy(out.data() + at, &v, sizeof(T));
+}
+
+// One row: runs of 3+ equal pixels become a run token, the rest literals
+static void rleRow(const uint32_t* p, int n, std::vector<uint8_t>& out)
+{
+    int i = 0;
+    while (i < n) {
+        int run = 1;
+        while (i + run < n && run < 0x7fff && p[i + run] == p[i]) ++run;
+        if (run >= 3) {
+            put(out, uint16_t(0x8000 | run));
+            put(out, p[i]);
+            i += run;
+            continue;
+        }
+        int lit = 0;
+        while (i + lit < n && lit < 0x7fff) {
+            if (i + lit + 2 < n && p[i + lit] == p[i + lit + 1] && p[i + lit] == p[i + lit + 2]) break;
+            ++lit;
+        }
+        put(out, uint16_t(lit));
+        const size_t at = out.size();
+        out.resize(at + size_t(lit) * 4);
+        std::memcpy(out.data() + at, p + i, size_t(lit) * 4);
+        i += lit;
+    }
+}
+
+static void copyRect(const uint32_t* src, int srcStride, uint32_t* dst, int dstStride,
+                     const FrameRecorder::Rect& r)
+{
+    for (int y = r.y; y < r.y + r.h; ++y)
+        std::memcpy(dst + size_t(y) * dstStride + r.x, src + size_t(y) * srcStride + r.x, size_t(r.w) * 4);
+}
+
+bool FrameRecorder::start(const std::string& path, int slots, int keyInterval)
+{
+    stop();
+    m_out.open(path, std::ios::binary | std::ios::trunc);
+    if (!m_out) return false;
+    m_out.write(kFileMagic, sizeof(kFileMagic));
+
+    m_slots.assign(size_t(std::max(1, slots)), Slot());
+    m_free.clear();
+    for (int i = 0; i < int(m_slots.size()); ++i) {
+        m_slots[i].rects.reserve(kMaxRects);
+        m_free.push_back(i);
+    }
+    m_queue.clear();
+    m_stopping = false;
+    m_lastW = m_lastH = 0;
+    m_keyInterval = std::max(1, keyInterval);
+    m_sinceKey = 0;
+    m_canvasW = m_canvasH = 0;
+    m_stats = Stats();
+    m_stats.bytes = sizeof(kFileMagic);
+    m_encodeSumUs = 0.0;
+
+    m_thread = std::thread(&FrameRecorder::run, this);
+    return true;
+}
+
+void FrameRecorder::stop()
+{
+    if (!m_thread.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_cv.notify_one();
+    m_thread.join();
+    m_out.close();
+}
+
+bool FrameRecorder::submit(const uint32_t* pixels, int stride, int w, int h,
+                           const Rect* rects, int count, const Meta& meta)
+{
+    if (!isRecording() || w <= 0 || h <= 0) return false;
+
+    int index;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_free.empty()) {
+            ++m_stats.dropped;
+            return false;
+        }
+        index = m_free.back();
+        m_free.pop_back();
+    }
+
+    // The slot is ours until queued; its buffer only grows on a size change
+    Slot& s = m_slots[size_t(index)];
+    if (s.pixels.size() != size_t(w) * h) s.pixels.resize(size_t(w) * h);
+    s.width = w;
+    s.height = h;
+    s.meta = meta;
+    s.rects.clear();
+
+    if (w != m_lastW || h != m_lastH) {
+        s.rects.push_back(Rect{ 0, 0, w, h });
+    } else {
+        Rect bound{ w, h, 0, 0 };   // as x0 y0 x1 y1
+        for (int i = 0; i < count; ++i) {
+            Rect r;
+            r.x = std::max(rects[i].x, 0);
+            r.y = std::max(rects[i].y, 0);
+            r.w = std::min(rects[i].x + rects[i].w, w) - r.x;
+            r.h = std::min(rects[i].y + rects[i].h, h) - r.y;
+            if (r.w <= 0 || r.h <= 0) continue;
+            bound = Rect{ std::min(bound.x, r.x), std::min(bound.y, r.y),
+                          std::max(bound.w, r.x + r.w), std::max(bound.h, r.y + r.h) };
+            if (count <= kMaxRects) s.rects.push_back(r);
+        }
+        if (count > kMaxRects && bound.w > bound.x)
+            s.rects.push_back(Rect{ bound.x, bound.y, bound.w - bound.x, bound.h - bound.y });
+    }
+    m_lastW = w;
+    m_lastH = h;
+
+    for (const Rect& r : s.rects)
+        copyRect(pixels, stride, s.pixels.data(), w, r);
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_queue.push_back(index);
+    }
+    m_cv.notify_one();
+    return true;
+}
+
+FrameRecorder::Stats FrameRecorder::takeStats()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Stats st = m_stats;
+    st.meanEncodeUs = st.frames ? m_encodeSumUs / st.frames : 0.0;
+    m_stats.frames = m_stats.dropped = m_stats.keyFrames = 0;
+    m_encodeSumUs = 0.0;
+    return st;
+}
+
+void FrameRecorder::run()
+{
+    for (;;) {
+        int index;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cv.wait(lock, [this] { return m_stopping || !m_queue.empty(); });
+            if (m_queue.empty()) return;   // stopping, and everything is written
+            index = m_queue.front();
+            m_queue.pop_front();
+        }
+
+        const auto t0 = std::chrono::steady_clock::now();
+        encode(m_slots[size_t(index)]);
+        const double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_free.push_back(index);
+        ++m_stats.frames;
+        m_encodeSumUs += us;
+    }
+}
+
+void FrameRecorder::encode(Slot& s)
+{
+    // Keep a full copy of the displayed frame for key frames
+    bool key = ++m_sinceKey >= m_keyInterval;
+    if (s.width != m_canvasW || s.height != m_canvasH) {
+        m_canvas.assign(size_t(s.width) * s.height, 0xff000000u);
+        m_canvasW = s.width;
+        m_canvasH = s.height;
+        key = true;
+    }
+    for (const Rect& r : s.rects)
+        copyRect(s.pixels.data(), s.width, m_canvas.data(), m_canvasW, r);
+
+    const Rect full{ 0, 0, m_canvasW, m_canvasH };
+    const Rect* rects = key ? &full : s.rects.data();
+    const int count = key ? 1 : int(s.rects.size());
+
+    m_buf.clear();
+    for (int i = 0; i < count; ++i) {
+        const Rect& r = rects[i];
+        const size_t at = m_buf.size();
+        put(m_buf, RectHeader());
+        for (int y = r.y; y < r.y + r.h; ++y)
+            rleRow(m_canvas.data() + size_t(y) * m_canvasW + r.x, r.w, m_buf);
+
+        RectHeader rh;
+        rh.x = r.x;  rh.y = r.y;  rh.w = r.w;  rh.h = r.h;
+        rh.bytes = uint32_t(m_buf.size() - at - sizeof(RectHeader));
+        std::memcpy(m_buf.data() + at, &rh, sizeof(rh));
+    }
+
+    FrameHeader fh;
+    fh.flags = key ? kKeyFrame : 0;
+    fh.width = m_canvasW;
+    fh.height = m_canvasH;
+    fh.meta = s.meta;
+    fh.rectCount = uint32_t(count);
+    fh.payloadBytes = uint32_t(m_buf.size());
+    m_out.write(reinterpret_cast<const char*>(&fh), sizeof(fh));
+    m_out.write(reinterpret_cast<const char*>(m_buf.data()), std::streamsize(m_buf.size()));
+    if (key) m_sinceKey = 0;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stats.bytes += sizeof(fh) + m_buf.size();
+    if (key) ++m_stats.keyFrames;
+}
+
+// ---------------------------------------------------------------------------
+// Reader
+
+bool FrameRecorder::Reader::open(const std::string& path)
+{
+    m_in.open(path, std::ios::binary);
+    char magic[sizeof(kFileMagic)];
+    return m_in.read(magic, sizeof(magic)) && std::memcmp(magic, kFileMagic, sizeof(magic)) == 0;
+}
+
+bool FrameRecorder::Reader::next(std::vector<uint32_t>& canvas, FrameHeader& header)
+{
+    if (!m_in.read(reinterpret_cast<char*>(&header), sizeof(header))) return false;
+    if (header.magic != kFrameMagic || header.width <= 0 || header.height <= 0) return false;
+    m_payload.resize(header.payloadBytes);
+    if (!m_in.read(reinterpret_cast<char*>(m_payload.data()), std::streamsize(m_payload.size()))) return false;
+
+    const size_t px = size_t(header.width) * header.height;
+    if (canvas.size() != px) canvas.assign(px, 0xff000000u);
+
+    const uint8_t* p = m_payload.data();
+    const uint8_t* end = p + m_payload.size();
+    for (uint32_t i = 0; i < header.rectCount; ++i) {
+        RectHeader rh;
+        if (end - p < ptrdiff_t(sizeof(rh))) return false;
+        std::memcpy(&rh, p, sizeof(rh));
+        p += sizeof(rh);
+        if (rh.x < 0 || rh.y < 0 || rh.w < 0 || rh.h < 0 ||
+            rh.x + rh.w > header.width || rh.y + rh.h > header.height || end - p < ptrdiff_t(rh.bytes))
+            return false;
+
+        const uint8_t* q = p;
+        const uint8_t* qend = p + rh.bytes;
+        for (int y = rh.y; y < rh.y + rh.h; ++y) {
+            uint32_t* row = canvas.data() + size_t(y) * header.width + rh.x;
+            int x = 0;
+            while (x < rh.w) {
+                uint16_t token;
+                if (qend - q < 2) return false;
+                std::memcpy(&token, q, 2);
+                q += 2;
+                const int n = token & 0x7fff;
+                if (n == 0 || x + n > rh.w) return false;
+                if (token & 0x8000) {
+                    uint32_t v;
+                    if (qend - q < 4) return false;
+                    std::memcpy(&v, q, 4);
+                    q += 4;
+                    std::fill(row + x, row + x + n, v);
+                } else {
+                    if (qend - q < ptrdiff_t(n) * 4) return false;
+                    std::memcpy(row + x, q, size_t(n) * 4);
+                    q += size_t(n) * 4;
+                }
+                x += n;
+            }
+        }
+        p = qend;
+    }
+    return true;
+}
@@ -0,0 +1,118 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Records the frames the HUD displayed, for debriefs, without stalling it.
+//
+// The render thread hands each frame over with submit(): only the rects
+// that changed since the last accepted frame are copied into a free slot of
+// a fixed pool (buffers are reused, nothing is allocated per frame) and the
+// slot is queued. An encoder thread applies the rects to its own copy of
+// the frame and writes them run-length encoded (HUD frames are mostly black
+// and mostly unchanged), with a full key frame every keyInterval frames.
+// When every slot is still queued the frame is dropped and submit() returns
+// false; the caller keeps accumulating its dirty rects for the next one.
+//
+// File (.hudrec, little-endian): "HUDREC1\0", then per frame a FrameHeader,
+// rectCount RectHeaders each followed by its RLE data. RLE tokens are a
+// uint16: 0x8000 | n = n copies of the next uint32 pixel, otherwise n
+// literal pixels follow. Pixels are 0xAARRGGBB as in QImage::Format_RGB32.
+class FrameRecorder {
+public:
+    struct Meta {
+        int64_t frameUs = 0;      // steady clock, end of paint
+        int64_t sampleTsUs = 0;   // device clock of the displayed sample (0 = none)
+        int64_t sampleHostUs = 0; // steady clock at its arrival (HudSample::hostUs)
+    };
+    struct Rect { int x = 0, y = 0, w = 0, h = 0; };
+
+    struct FrameHeader {
+        uint32_t magic = kFrameMagic;
+        uint32_t flags = 0;       // kKeyFrame
+        int32_t  width = 0, height = 0;
+        Meta     meta;
+        uint32_t rectCount = 0;
+        uint32_t payloadBytes = 0;   // everything after this header
+    };
+    struct RectHeader {
+        int32_t  x = 0, y = 0, w = 0, h = 0;
+        uint32_t bytes = 0;
+    };
+    static constexpr uint32_t kFrameMagic = 0x454d5246;   // "FRME"
+    static constexpr uint32_t kKeyFrame = 1;
+    static constexpr int kMaxRects = 32;   // more are merged into one
+
+    struct Stats {
+        int      frames = 0;      // encoded since the last call
+        int      dropped = 0;     // refused by submit()
+        int      keyFrames = 0;
+        double   meanEncodeUs = 0.0;
+        uint64_t bytes = 0;       // file size so far
+    };
+
+    FrameRecorder() = default;
+    ~FrameRecorder() { stop(); }
+    FrameRecorder(const FrameRecorder&) = delete;
+    FrameRecorder& operator=(const FrameRecorder&) = delete;
+
+    bool start(const std::string& path, int slots = 3, int keyInterval = 120);
+    void stop();   // encodes what is queued, then closes the file
+    bool isRecording() const { return m_thread.joinable(); }
+
+    // Render thread. pixels / stride (in pixels) describe the whole w x h
+    // frame; rects are what changed since the last accepted frame (ignored,
+    // i.e. the whole frame is taken, when the size changed).
+    bool submit(const uint32_t* pixels, int stride, int w, int h,
+                const Rect* rects, int count, const Meta& meta);
+
+    Stats takeStats();
+
+    // Plays a recording back frame by frame into a full canvas
+    class Reader {
+    public:
+        bool open(const std::string& path);
+        bool next(std::vector<uint32_t>& canvas, FrameHeader& header);
+
+    private:
+        std::ifstream m_in;
+        std::vector<uint8_t> m_payload;
+    };
+
+private:
+    struct Slot {
+        std::vector<uint32_t> pixels;   // full frame size, only rects valid
+        std::vector<Rect> rects;        // capacity kMaxRects
+        int width = 0, height = 0;
+        Meta meta;
+    };
+
+    void run();
+    void encode(Slot& s);
+
+    std::ofstream m_out;
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::vector<Slot> m_slots;
+    std::vector<int> m_free;        // slot indices
+    std::deque<int> m_queue;
+    bool m_stopping = false;
+    int m_lastW = 0, m_lastH = 0;   // size of the last accepted frame
+
+    // Encoder thread only
+    int m_keyInterval = 120;
+    int m_sinceKey = 0;
+    std::vector<uint32_t> m_canvas;
+    int m_canvasW = 0, m_canvasH = 0;
+    std::vector<uint8_t> m_buf;
+
+    // Under m_mutex
+    Stats m_stats;
+    double m_encodeSumUs = 0.0;
+};
@@ -0,0 +1,149 @@
+#include "FrameScheduler.h"
+
+#include "SteadyClock.h"
+
+#include <QScreen>
+#include <cmath>
+
+qint64 FrameScheduler::nowUs()
+{
+    return steadyNowUs();
+}
+
+FrameScheduler::FrameScheduler(QObject* parent) : QObject(parent)
+{
+    m_timer.setSingleShot(true);
+    m_timer.setTimerType(Qt::PreciseTimer);
+    connect(&m_timer, &QTimer::timeout, this, &FrameScheduler::onTimeout);
+}
+
+void FrameScheduler::setScreen(QScreen* screen)
+{
+    if (m_screen == screen) return;
+    disconnect(m_screenConn);
+    m_screen = screen;
+    if (!screen) return;
+    setRefreshHz(screen->refreshRate());
+    m_screenConn = connect(screen, &QScreen::refreshRateChanged, this, &FrameScheduler::setRefreshHz);
+}
+
+void FrameScheduler::setRefreshHz(double hz)
+{
+    // Some platforms report 0 or nonsense; keep the last sane value
+    if (hz < 20.0 || hz > 500.0) return;
+    m_periodUs = 1e6 / hz;
+}
+
+void FrameScheduler::start()
+{
+    m_running = true;
+    m_nextVsyncUs = double(nowUs()) + m_periodUs;
+    schedule();
+}
+
+void FrameScheduler::stop()
+{
+    m_running = false;
+    m_timer.stop();
+}
+
+void FrameScheduler::noteVsync(qint64 tUs)
+{
+    m_lastNoteUs = tUs;
+    if (!m_running) return;
+
+    // Phase error against the nearest modelled vblank, in (-P/2, P/2]
+    double err = std::fmod(double(tUs) - m_nextVsyncUs, m_periodUs);
+    if (err > m_periodUs / 2) err -= m_periodUs;
+    if (err <= -m_periodUs / 2) err += m_periodUs;
+
+    // Gentle first-order loop: one stray timestamp moves the phase by 1/8
+    m_nextVsyncUs += err / 8.0;
+}
+
+void FrameScheduler::noteFlip(qint64 vblankUs, qint64 targetUs)
+{
+    noteVsync(vblankUs);
+    m_flipNoted = true;
+    if (double(vblankUs) - m_periodUs / 2 > double(targetUs)) ++m_missed;
+}
+
+void FrameScheduler::wake()
+{
+    m_divider = 1;
+    if (!m_running) return;
+
+    // Same vblank train, earliest frame that can still be made
+    const double earliest = double(nowUs()) + m_renderAheadUs / 2;
+    double next = m_nextVsyncUs;
+    while (next - m_periodUs >= earliest) next -= m_periodUs;
+    if (next < m_nextVsyncUs) {
+        m_nextVsyncUs = next;
+        schedule();
+    }
+}
+
+void FrameScheduler::schedule()
+{
+    if (!m_running) return;
+    m_plannedWakeUs = qint64(m_nextVsyncUs) - m_renderAheadUs;
+    // QTimer has millisecond resolution: round down so we wake early
+    // rather than late (at most 1 ms of extra render-ahead)
+    const qint64 waitUs = m_plannedWakeUs - nowUs();
+    m_timer.start(int(qMax<qint64>(0, waitUs / 1000)));
+}
+
+void FrameScheduler::onTimeout()
+{
+    const qint64 wake = nowUs();
+    m_wakeErrSumUs += double(wake - m_plannedWakeUs);
+
+    // Woke too late to make this vblank (busy event loop, scheduler
+    // latency): count it and aim for the first one still reachable
+    if (double(wake) + m_renderAheadUs / 2 > m_nextVsyncUs) {
+        const double behind = double(wake) + m_renderAheadUs / 2 - m_nextVsyncUs;
+        const int skipped = int(std::ceil(behind / m_periodUs));
+        m_missed += skipped;
+        m_nextVsyncUs += skipped * m_periodUs;
+    }
+
+    const qint64 target = qint64(m_nextVsyncUs);
+    const qint64 noteBefore = m_lastNoteUs;
+    m_flipNoted = false;
+    emit frame(target);
+    const qint64 done = nowUs();
+
+    const double renderUs = double(done - wake);
+    ++m_frames;
+    m_renderSumUs += renderUs;
+    if (renderUs > m_renderMaxUs) m_renderMaxUs = renderUs;
+
+    // A blocking swap reports the vblank it landed on; otherwise judge by
+    // when rendering finished. Flips reported by noteFlip() were judged
+    // there, against the frame they belong to.
+    if (!m_flipNoted) {
+        const bool noted = m_lastNoteUs != noteBefore;
+        const double landed = noted ? double(m_lastNoteUs) - m_periodUs / 2 : double(done);
+        if (landed > double(target)) ++m_missed;
+    }
+
+    m_nextVsyncUs += m_divider * m_periodUs;
+    while (double(nowUs()) + m_renderAheadUs / 2 > m_nextVsyncUs)
+        m_nextVsyncUs += m_periodUs;
+    schedule();
+}
+
+FrameScheduler::Stats FrameScheduler::takeStats()
+{
+    Stats st;
+    st.frames = m_frames;
+    st.missed = m_missed;
+    st.refreshHz = 1e6 / m_periodUs;
+    st.meanWakeErrUs = m_frames ? m_wakeErrSumUs / m_frames : 0.0;
+    st.meanRenderUs = m_frames ? m_renderSumUs / m_frames : 0.0;
+    st.maxRenderUs = m_renderMaxUs;
+    st.phaseLocked = m_lastNoteUs != 0;
+    m_frames = m_missed = 0;
+    m_wakeErrSumUs = m_renderSumUs = m_renderMaxUs = 0.0;
+    return st;
+}
@@ -0,0 +1,92 @@
+#pragma once
+#include <QObject>
+#include <QPointer>
+#include <QTimer>
+
+class QScreen;
+
+// Vsync-aligned frame pacing.
+//
+// Keeps a model of the display's vblank train (period from
+// QScreen::refreshRate(), phase from noteVsync() when the platform gives us
+// a presentation timestamp) and wakes once per refresh, renderAhead before
+// the next vblank. frame() is emitted with that vblank's time; the handler
+// samples the latest state and renders synchronously, so there is exactly
+// one render per refresh and never two in the same one.
+//
+// Every vblank that passes without its frame (render finished late, or the
+// wake-up came too late to start) counts as missed, and the schedule skips
+// ahead to the next vblank that can still be made.
+//
+// Without noteVsync() the train free-runs at the exact refresh rate: no
+// beat against the display, but at an unknown constant phase.
+
+class FrameScheduler : public QObject {
+    Q_OBJECT
+public:
+    struct Stats {
+        int    frames = 0;
+        int    missed = 0;
+        double refreshHz = 0;
+        double meanWakeErrUs = 0;   // actual - planned wake-up
+        double meanRenderUs = 0;    // incl. a blocking swap, if any
+        double maxRenderUs = 0;
+        bool   phaseLocked = false;
+    };
+
+    explicit FrameScheduler(QObject* parent = nullptr);
+
+    // Period from the screen; follows refresh-rate changes
+    void setScreen(QScreen* screen);
+    void setRefreshHz(double hz);
+    void setRenderAheadUs(qint64 us) { m_renderAheadUs = us; }
+
+    // Render only every n-th vblank (IdlePolicy); skipped ones aren't
+    // missed. wake() goes back to every vblank and pulls the next frame in
+    // to the first one still reachable.
+    void setDivider(int n) { m_divider = qMax(1, n); }
+    void wake();
+
+    void start();
+    void stop();
+
+    // Presentation timestamp (steady clock, us) of a vblank, e.g. when a
+    // blocking buffer swap returned. Pulls the phase in gradually.
+    void noteVsync(qint64 tUs);
+    // A flip that completed at vblankUs showing the frame emitted for
+    // targetUs, possibly an earlier frame than the current one (KMS reports
+    // a flip only once the next frame waits for it). Same phase pull, and
+    // the miss is judged against that frame's own target.
+    void noteFlip(qint64 vblankUs, qint64 targetUs);
+
+    Stats takeStats();
+
+    static qint64 nowUs();
+
+signals:
+    // Render now; the result is meant for the vblank at vsyncUs
+    void frame(qint64 vsyncUs);
+
+private slots:
+    void onTimeout();
+
+private:
+    void schedule();
+
+    QTimer m_timer;
+    QPointer<QScreen> m_screen;
+    QMetaObject::Connection m_screenConn;
+
+    double m_periodUs = 1e6 / 60.0;
+    qint64 m_renderAheadUs = 4000;
+    int    m_divider = 1;
+    double m_nextVsyncUs = 0;      // target of the next frame
+    qint64 m_plannedWakeUs = 0;
+    qint64 m_lastNoteUs = 0;       // last noteVsync() arrival
+    bool   m_flipNoted = false;    // noteFlip() during this frame
+    bool   m_running = false;
+
+    int    m_frames = 0, m_missed = 0;
+    double m_wakeErrSumUs = 0;
+    double m_renderSumUs = 0, m_renderMaxUs = 0;
+};
@@ -0,0 +1,507 @@
+#include "FramebufferOutput.h"
+#include "SteadyClock.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <new>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <linux/fb.h>
+
+#ifdef HUD_HAVE_LIBDRM
+#include <xf86drm.h>
+#include <xf86drmMode.h>
+#endif
+
+static_assert(sizeof(FramebufferOutput::FileHeader) == 56, "FileHeader layout");
+
+static const char kFileMagic[8] = { 'H', 'U', 'D', 'F', 'B', '1', '\0', '\0' };
+
+static bool fail(std::string* error, const std::string& what)
+{
+    if (error) *error = what;
+    return false;
+}
+
+// One output. buffer[i] are mapped, count is 1 (drawn in place) or 2.
+struct FramebufferOutput::Backend {
+    virtual ~Backend() = default;
+
+    // Until buffer i is no longer scanned out
+    virtual void waitFree(int) {}
+    virtual bool flip(int i) = 0;
+
+    const char* kind = "";
+    int      width = 0, height = 0;
+    int      stride = 0;          // bytes
+    Format   format = XRGB8888;
+    int      count = 1;
+    uint8_t* buffer[2] = { nullptr, nullptr };
+    double   refreshHz = 0.0;
+    int64_t  queuedTarget = 0;    // frame target of the flip in flight
+    int64_t  vblankUs = 0;        // last completed flip, and its target
+    int64_t  vblankTarget = 0;
+};
+
+namespace {
+
+// ---- fbdev ----
+
+struct FbdevBackend : FramebufferOutput::Backend {
+    int fd = -1;
+    uint8_t* map = nullptr;
+    size_t mapBytes = 0;
+    fb_var_screeninfo var{};
+
+    ~FbdevBackend() override
+    {
+        if (map) {
+            // Leave the first page showing for whatever runs next
+            if (count == 2 && var.yoffset != 0) {
+                var.yoffset = 0;
+                ioctl(fd, FBIOPAN_DISPLAY, &var);
+            }
+            munmap(map, mapBytes);
+        }
+        if (fd >= 0) ::close(fd);
+    }
+
+    bool open(const std::string& dev, std::string* error)
+    {
+        kind = "fb";
+        fd = ::open(dev.c_str(), O_RDWR | O_CLOEXEC);
+        if (fd < 0) return fail(error, "cannot open " + dev);
+
+        fb_fix_screeninfo fix{};
+        if (ioctl(fd, FBIOGET_VSCREENINFO, &var) < 0) return fail(error, "FBIOGET_VSCREENINFO failed");
+
+        // Ask for a second page below the visible one
+        if (var.yres_virtual < 2 * var.yres) {
+            fb_var_screeninfo v = var;
+            v.yres_virtual = 2 * var.yres;
+            v.yoffset = 0;
+            if (ioctl(fd, FBIOPUT_VSCREENINFO, &v) == 0) ioctl(fd, FBIOGET_VSCREENINFO, &var);
+        }
+        if (ioctl(fd, FBIOGET_FSCREENINFO, &fix) < 0) return fail(error, "FBIOGET_FSCREENINFO failed");
+
+        if (var.bits_per_pixel == 32 && var.red.offset == 16 && var.green.offset == 8 && var.blue.offset == 0)
+            format = FramebufferOutput::XRGB8888;
+        else if (var.bits_per_pixel == 16 && var.red.offset == 11 && var.green.offset == 5 && var.blue.offset == 0)
+            format = FramebufferOutput::RGB565;
+        else
+            return fail(error, "unsupported fbdev pixel format (" + std::to_string(var.bits_per_pixel) + " bpp)");
+
+        width = int(var.xres);
+        height = int(var.yres);
+        stride = int(fix.line_length);
+        const size_t page = size_t(stride) * height;
+        count = (var.yres_virtual >= 2 * var.yres && fix.smem_len >= 2 * page) ? 2 : 1;
+
+        mapBytes = std::min<size_t>(fix.smem_len, page * count);
+        void* p = mmap(nullptr, mapBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (p == MAP_FAILED) return fail(error, "mmap of " + dev + " failed");
+        map = static_cast<uint8_t*>(p);
+        for (int i = 0; i < count; ++i) buffer[i] = map + i * page;
+
+        if (var.pixclock) {
+            const double htotal = var.xres + var.left_margin + var.right_margin + var.hsync_len;
+            const double vtotal = var.yres + var.upper_margin + var.lower_margin + var.vsync_len;
+            refreshHz = 1e12 / (double(var.pixclock) * htotal * vtotal);
+        }
+
+        if (count == 2 && var.yoffset != 0) flip(0);
+        return true;
+    }
+
+    bool flip(int i) override
+    {
+        if (count < 2) return true;
+        var.yoffset = uint32_t(i) * var.yres;
+        if (ioctl(fd, FBIOPAN_DISPLAY, &var) < 0) return false;
+        // Not every driver has it; without, the pan may tear
+        uint32_t crtc = 0;
+        if (ioctl(fd, FBIO_WAITFORVSYNC, &crtc) == 0) {
+            vblankUs = steadyNowUs();
+            vblankTarget = queuedTarget;
+        }
+        return true;
+    }
+};
+
+// ---- KMS dumb buffers ----
+
+#ifdef HUD_HAVE_LIBDRM
+struct DrmBackend : FramebufferOutput::Backend {
+    int fd = -1;
+    uint32_t connectorId = 0, crtcId = 0;
+    drmModeModeInfo mode{};
+    drmModeCrtc* saved = nullptr;
+    uint32_t handle[2] = {}, fbId[2] = {};
+    size_t bytes = 0;
+    bool pending = false;
+
+    ~DrmBackend() override
+    {
+        if (fd < 0) return;
+        waitFree(0);
+        if (saved) {
+            drmModeSetCrtc(fd, saved->crtc_id, saved->buffer_id, saved->x, saved->y,
+                           &connectorId, 1, &saved->mode);
+            drmModeFreeCrtc(saved);
+        }
+        for (int i = 0; i < 2; ++i) {
+            if (buffer[i]) munmap(buffer[i], bytes);
+            if (fbId[i]) drmModeRmFB(fd, fbId[i]);
+            if (handle[i]) {
+                drm_mode_destroy_dumb d{};
+                d.handle = handle[i];
+                drmIoctl(fd, DRM_IOCTL_MODE_DESTROY_DUMB, &d);
+            }
+        }
+        ::close(fd);
+    }
+
+    bool pickOutput(std::string* error)
+    {
+        drmModeRes* res = drmModeGetResources(fd);
+        if (!res) return fail(error, "not a KMS device");
+
+        for (int c = 0; c < res->count_connectors && !crtcId; ++c) {
+            drmModeConnector* conn = drmModeGetConnector(fd, res->connectors[c]);
+            if (!conn) continue;
+            if (conn->connection == DRM_MODE_CONNECTED && conn->count_modes > 0) {
+                mode = conn->modes[0];
+                for (int m = 0; m < conn->count_modes; ++m)
+                    if (conn->modes[m].type & DRM_MODE_TYPE_PREFERRED) { mode = conn->modes[m]; break; }
+
+                // The CRTC already driving it, else the first one an
+                // encoder of the connector can use
+                if (drmModeEncoder* enc = conn->encoder_id ? drmModeGetEncoder(fd, conn->encoder_id) : nullptr) {
+                    crtcId = enc->crtc_id;
+                    drmModeFreeEncoder(enc);
+                }
+                for (int e = 0; e < conn->count_encoders && !crtcId; ++e) {
+                    drmModeEncoder* enc = drmModeGetEncoder(fd, conn->encoders[e]);
+                    if (!enc) continue;
+                    for (int k = 0; k < res->count_crtcs; ++k)
+                        if (enc->possible_crtcs & (1u << k)) { crtcId = res->crtcs[k]; break; }
+                    drmModeFreeEncoder(enc);
+                }
+                if (crtcId) connectorId = conn->connector_id;
+            }
+            drmModeFreeConnector(conn);
+        }
+        drmModeFreeResources(res);
+        return crtcId ? true : fail(error, "no connected display with a usable CRTC");
+    }
+
+    bool open(const std::string& dev, std::string* error)
+    {
+        kind = "drm";
+        fd = ::open(dev.c_str(), O_RDWR | O_CLOEXEC);
+        if (fd < 0) return fail(error, "cannot open " + dev);
+        if (!pickOutput(error)) return false;
+
+        width = mode.hdisplay;
+        height = mode.vdisplay;
+        format = FramebufferOutput::XRGB8888;
+        count = 2;
+        refreshHz = (mode.htotal && mode.vtotal)
+                        ? mode.clock * 1000.0 / (double(mode.htotal) * mode.vtotal) : mode.vrefresh;
+
+        for (int i = 0; i < 2; ++i) {
+            drm_mode_create_dumb create{};
+            create.width = uint32_t(width);
+            create.height = uint32_t(height);
+            create.bpp = 32;
+            if (drmIoctl(fd, DRM_IOCTL_MODE_CREATE_DUMB, &create) < 0) return fail(error, "CREATE_DUMB failed");
+            handle[i] = create.handle;
+            stride = int(create.pitch);
+            bytes = size_t(create.size);
+
+            if (drmModeAddFB(fd, uint32_t(width), uint32_t(height), 24, 32, create.pitch, create.handle, &fbId[i]))
+                return fail(error, "drmModeAddFB failed");
+
+            drm_mode_map_dumb map{};
+            map.handle = create.handle;
+            if (drmIoctl(fd, DRM_IOCTL_MODE_MAP_DUMB, &map) < 0) return fail(error, "MAP_DUMB failed");
+            void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, map.offset);
+            if (p == MAP_FAILED) return fail(error, "mmap of dumb buffer failed");
+            buffer[i] = static_cast<uint8_t*>(p);
+            std::memset(buffer[i], 0, bytes);
+        }
+
+        saved = drmModeGetCrtc(fd, crtcId);
+        if (drmModeSetCrtc(fd, crtcId, fbId[0], 0, 0, &connectorId, 1, &mode))
+            return fail(error, "drmModeSetCrtc failed (is another display server holding DRM master?)");
+        return true;
+    }
+
+    static void onFlip(int, unsigned, unsigned sec, unsigned usec, void* data)
+    {
+        DrmBackend* self = static_cast<DrmBackend*>(data);
+        self->pending = false;
+        self->vblankUs = int64_t(sec) * 1000000 + usec;
+        self->vblankTarget = self->queuedTarget;
+    }
+
+    // The back buffer is the old front until the queued flip has happened
+    void waitFree(int) override
+    {
+        drmEventContext ctx{};
+        ctx.version = 2;
+        ctx.page_flip_handler = &DrmBackend::onFlip;
+        while (pending) {
+            pollfd pfd{ fd, POLLIN, 0 };
+            // A lost event must not hang the HUD
+            if (poll(&pfd, 1, 100) <= 0) { pending = false; break; }
+            drmHandleEvent(fd, &ctx);
+        }
+    }
+
+    bool flip(int i) override
+    {
+        if (drmModePageFlip(fd, crtcId, fbId[i], DRM_MODE_PAGE_FLIP_EVENT, this)) return false;
+        pending = true;
+        return true;
+    }
+};
+#endif
+
+// ---- File stand-in ----
+
+struct FileBackend : FramebufferOutput::Backend {
+    int fd = -1;
+    uint8_t* map = nullptr;
+    size_t mapBytes = 0;
+    FramebufferOutput::FileHeader* header = nullptr;
+
+    ~FileBackend() override
+    {
+        if (map) munmap(map, mapBytes);
+        if (fd >= 0) ::close(fd);
+    }
+
+    bool open(const std::string& arg, std::string* error)
+    {
+        kind = "file";
+        std::string path = arg;
+        width = 1280;
+        height = 720;
+        const size_t at = arg.rfind('@');
+        if (at != std::string::npos) {
+            path = arg.substr(0, at);
+            if (std::sscanf(arg.c_str() + at + 1, "%dx%d", &width, &height) != 2 ||
+                width <= 0 || height <= 0 || width > 8192 || height > 8192)
+                return fail(error, "bad size in " + arg + " (want PATH@WxH)");
+        }
+
+        format = FramebufferOutput::XRGB8888;
+        stride = width * 4;
+        count = 2;
+        const size_t dataOffset = 4096;
+        const size_t page = size_t(stride) * height;
+        mapBytes = dataOffset + 2 * page;
+
+        fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0) return fail(error, "cannot create " + path);
+        if (ftruncate(fd, off_t(mapBytes)) < 0) return fail(error, "cannot size " + path);
+        void* p = mmap(nullptr, mapBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (p == MAP_FAILED) return fail(error, "mmap of " + path + " failed");
+        map = static_cast<uint8_t*>(p);
+        buffer[0] = map + dataOffset;
+        buffer[1] = map + dataOffset + page;
+
+        header = new (map) FramebufferOutput::FileHeader;
+        header->width = uint32_t(width);
+        header->height = uint32_t(height);
+        header->stride = uint32_t(stride);
+        header->format = format;
+        header->buffers = 2;
+        header->dataOffset = uint32_t(dataOffset);
+        // Magic last: a reader that sees it sees a valid header
+        std::atomic_thread_fence(std::memory_order_release);
+        std::memcpy(header->magic, kFileMagic, sizeof(kFileMagic));
+        return true;
+    }
+
+    bool flip(int i) override
+    {
+        // Pixels before the index, for a reader polling the mapping
+        std::atomic_thread_fence(std::memory_order_release);
+        header->flipUs = steadyNowUs();
+        ++header->flips;
+        header->front = uint32_t(i);
+        return true;
+    }
+};
+
+} // namespace
+
+FramebufferOutput::FramebufferOutput() = default;
+FramebufferOutput::~FramebufferOutput() { close(); }
+
+bool FramebufferOutput::open(const std::string& spec, std::string* error)
+{
+    close();
+
+    std::string kind, arg = spec;
+    const size_t colon = spec.find(':');
+    if (colon != std::string::npos && colon > 0 && spec[0] != '/') {
+        kind = spec.substr(0, colon);
+        arg = spec.substr(colon + 1);
+    } else if (spec.rfind("/dev/dri/", 0) == 0) {
+        kind = "drm";
+    } else if (spec.rfind("/dev/fb", 0) == 0) {
+        kind = "fb";
+    } else {
+        kind = "file";
+    }
+
+    std::unique_ptr<Backend> b;
+    if (kind == "fb") {
+        auto fb = std::make_unique<FbdevBackend>();
+        if (!fb->open(arg, error)) return false;
+        b = std::move(fb);
+    } else if (kind == "drm") {
+#ifdef HUD_HAVE_LIBDRM
+        auto drm = std::make_unique<DrmBackend>();
+        if (!drm->open(arg, error)) return false;
+        b = std::move(drm);
+#else
+        return fail(error, "built without libdrm; use fb: or file:");
+#endif
+    } else if (kind == "file") {
+        auto file = std::make_unique<FileBackend>();
+        if (!file->open(arg, error)) return false;
+        b = std::move(file);
+    } else {
+        return fail(error, "unknown output \"" + kind + "\" (drm:, fb: or file:)");
+    }
+
+    m_backend = std::move(b);
+    m_front = 0;
+    m_written[0] = m_written[1] = false;
+    m_prevRects.clear();
+    m_unflipped.clear();
+    return true;
+}
+
+void FramebufferOutput::close()
+{
+    m_backend.reset();
+}
+
+int FramebufferOutput::width() const { return m_backend ? m_backend->width : 0; }
+int FramebufferOutput::height() const { return m_backend ? m_backend->height : 0; }
+int FramebufferOutput::bufferCount() const { return m_backend ? m_backend->count : 0; }
+double FramebufferOutput::refreshHz() const { return m_backend ? m_backend->refreshHz : 0.0; }
+const char* FramebufferOutput::kind() const { return m_backend ? m_backend->kind : ""; }
+FramebufferOutput::Flip FramebufferOutput::lastFlip() const
+{
+    Flip f;
+    if (m_backend) {
+        f.vblankUs = m_backend->vblankUs;
+        f.targetUs = m_backend->vblankTarget;
+    }
+    return f;
+}
+
+void FramebufferOutput::copyRect(const uint32_t* pixels, int stride, uint8_t* dst, const Rect& r) const
+{
+    const int dstStride = m_backend->stride;
+    if (m_backend->format == XRGB8888) {
+        for (int y = r.y; y < r.y + r.h; ++y)
+            std::memcpy(dst + size_t(y) * dstStride + size_t(r.x) * 4,
+                        pixels + size_t(y) * stride + r.x, size_t(r.w) * 4);
+        return;
+    }
+    for (int y = r.y; y < r.y + r.h; ++y) {
+        const uint32_t* s = pixels + size_t(y) * stride + r.x;
+        uint16_t* d = reinterpret_cast<uint16_t*>(dst + size_t(y) * dstStride) + r.x;
+        for (int x = 0; x < r.w; ++x) {
+            const uint32_t p = s[x];
+            d[x] = uint16_t(((p >> 8) & 0xf800) | ((p >> 5) & 0x07e0) | ((p >> 3) & 0x001f));
+        }
+    }
+}
+
+bool FramebufferOutput::present(const uint32_t* pixels, int stride, const Rect* rects, int count)
+{
+    if (!m_backend) return false;
+    Backend& b = *m_backend;
+    const int back = b.count == 2 ? 1 - m_front : 0;
+
+    const int64_t t0 = steadyNowUs();
+    b.waitFree(back);
+    const int64_t t1 = steadyNowUs();
+
+    auto clip = [&](Rect r) {
+        const int x1 = std::min(r.x + r.w, b.width), y1 = std::min(r.y + r.h, b.height);
+        r.x = std::max(r.x, 0);
+        r.y = std::max(r.y, 0);
+        r.w = x1 - r.x;
+        r.h = y1 - r.y;
+        return r;
+    };
+    if (!m_written[back]) {
+        copyRect(pixels, stride, b.buffer[back], Rect{ 0, 0, b.width, b.height });
+        m_written[back] = true;
+    } else {
+        // The back buffer also missed what the previous frame changed
+        if (b.count == 2)
+            for (const Rect& r : m_prevRects) {
+                const Rect c = clip(r);
+                if (c.w > 0 && c.h > 0) copyRect(pixels, stride, b.buffer[back], c);
+            }
+        for (int i = 0; i < count; ++i) {
+            const Rect c = clip(rects[i]);
+            if (c.w > 0 && c.h > 0) copyRect(pixels, stride, b.buffer[back], c);
+        }
+    }
+    const int64_t t2 = steadyNowUs();
+
+    b.queuedTarget = m_frameTarget;
+    const bool ok = b.flip(back);
+    if (ok) {
+        // The old front becomes the back: it misses this frame and any that
+        // never made it to the screen
+        m_front = back;
+        m_prevRects.swap(m_unflipped);
+        m_prevRects.insert(m_prevRects.end(), rects, rects + count);
+        m_unflipped.clear();
+    } else {
+        // Still scanning out the front: the next present() draws into the
+        // same back buffer again, and the front will miss these rects too
+        m_prevRects.clear();
+        m_unflipped.insert(m_unflipped.end(), rects, rects + count);
+        if (m_unflipped.size() > kMaxUnflipped)
+            m_unflipped.assign(1, Rect{ 0, 0, b.width, b.height });
+    }
+
+    ++m_flips;
+    m_waitSumUs += double(t1 - t0);
+    m_waitMaxUs = std::max(m_waitMaxUs, double(t1 - t0));
+    m_copySumUs += double(t2 - t1);
+    return ok;
+}
+
+FramebufferOutput::Stats FramebufferOutput::takeStats()
+{
+    Stats st;
+    st.flips = m_flips;
+    if (m_flips) {
+        st.meanCopyUs = m_copySumUs / m_flips;
+        st.meanWaitUs = m_waitSumUs / m_flips;
+    }
+    st.maxWaitUs = m_waitMaxUs;
+    m_flips = 0;
+    m_copySumUs = m_waitSumUs = m_waitMaxUs = 0.0;
+    return st;
+}
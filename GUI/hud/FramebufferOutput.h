@@ -0,0 +1,104 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Puts HUD frames on a display without a window system.
+//
+// Frames are rendered offscreen and present() copies the rects that changed
+// into the back buffer of the output, then flips it to the front. With two
+// buffers the back one is a frame behind, so the rects of the previous
+// present() are copied as well; a buffer that was never written gets the
+// whole frame. A flip that fails (busy, pan error) leaves the front as it
+// was; its rects are kept for the buffer that is still showing.
+//
+// Outputs (open() spec):
+//   drm:/dev/dri/card0   KMS dumb buffers on the first connected connector
+//                        at its preferred mode, flipped with drmModePageFlip.
+//                        present() waits for the previous flip, so it also
+//                        paces to the display. lastFlip() carries the kernel
+//                        flip timestamp (CLOCK_MONOTONIC, i.e. steady_clock);
+//                        it usually belongs to the previous present(), hence
+//                        the frame target it was tagged with.
+//                        Needs DRM master (no X / Wayland on that card) and
+//                        a build with libdrm (HUD_HAVE_LIBDRM).
+//   fb:/dev/fb0          fbdev; double-buffered by panning when the virtual
+//                        height can be doubled, else drawn in place.
+//   file:PATH@WxH        Stand-in for testing without display hardware: a
+//                        shared file mapping laid out as FileHeader + two
+//                        XRGB8888 buffers at dataOffset. flip() only updates
+//                        the header; fbfile_snap reads the front buffer.
+// Source pixels are QImage::Format_RGB32 (0xffRRGGBB); 16 bpp fbdev gets
+// RGB565.
+class FramebufferOutput {
+public:
+    enum Format : uint32_t { XRGB8888 = 0, RGB565 = 1 };
+    struct Rect { int x = 0, y = 0, w = 0, h = 0; };
+
+    struct FileHeader {
+        char     magic[8];        // "HUDFB1\0\0"
+        uint32_t width = 0, height = 0;
+        uint32_t stride = 0;      // bytes per row
+        uint32_t format = XRGB8888;
+        uint32_t buffers = 2;
+        uint32_t front = 0;       // written last on each flip
+        uint64_t flips = 0;
+        int64_t  flipUs = 0;      // steady clock of the last flip
+        uint32_t dataOffset = 0;  // buffer i at dataOffset + i * stride * height
+        uint32_t reserved = 0;
+    };
+
+    struct Stats {
+        int    flips = 0;         // since the last call
+        double meanCopyUs = 0.0;
+        double meanWaitUs = 0.0;  // for the back buffer to be free
+        double maxWaitUs = 0.0;
+    };
+
+    FramebufferOutput();
+    ~FramebufferOutput();
+    FramebufferOutput(const FramebufferOutput&) = delete;
+    FramebufferOutput& operator=(const FramebufferOutput&) = delete;
+
+    bool open(const std::string& spec, std::string* error = nullptr);
+    void close();
+    bool isOpen() const { return bool(m_backend); }
+
+    int    width() const;
+    int    height() const;
+    int    bufferCount() const;
+    double refreshHz() const;     // 0 = unknown
+    const char* kind() const;     // "drm", "fb", "file"
+
+    // pixels / stride (in pixels) describe a whole width() x height() frame;
+    // rects are what changed since the last present()
+    bool present(const uint32_t* pixels, int stride, const Rect* rects, int count);
+
+    // Vblank the next present() is meant for (FrameScheduler's target);
+    // returned with that flip in lastFlip()
+    void setFrameTarget(int64_t targetUs) { m_frameTarget = targetUs; }
+
+    // Last completed flip when the output reports it (vblankUs 0 if not),
+    // with the target of the frame it showed
+    struct Flip { int64_t vblankUs = 0, targetUs = 0; };
+    Flip lastFlip() const;
+
+    Stats takeStats();
+
+    struct Backend;
+
+private:
+    void copyRect(const uint32_t* pixels, int stride, uint8_t* dst, const Rect& r) const;
+
+    std::unique_ptr<Backend> m_backend;
+    int  m_front = 0;
+    bool m_written[2] = { false, false };
+    std::vector<Rect> m_prevRects;
+    std::vector<Rect> m_unflipped;    // drawn, but their flip failed
+    static constexpr size_t kMaxUnflipped = 64;   // then the whole frame
+    int64_t m_frameTarget = 0;
+
+    int    m_flips = 0;
+    double m_copySumUs = 0.0, m_waitSumUs = 0.0, m_waitMaxUs = 0.0;
+};
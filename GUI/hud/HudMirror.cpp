@@ -0,0 +1,145 @@
+#include "HudMirror.h"
+
+#include <QPaintEvent>
+#include <QPainter>
+
+HudMirror::HudMirror(QWidget *parent) : QWidget(parent)
+{
+    setAutoFillBackground(false);
+    setAttribute(Qt::WA_OpaquePaintEvent, true);
+    setAttribute(Qt::WA_NoSystemBackground, true);
+}
+
+void HudMirror::setScaling(Scaling scaling)
+{
+    m_scaling = scaling;
+    update();
+}
+
+void HudMirror::setWarp(const WarpMesh &mesh)
+{
+    m_warp = mesh.isValid();
+    m_warpMesh = mesh;
+    m_remap.clear();
+    m_warpOut = QImage();
+    m_warpSrcDirty = QRegion();
+    update();
+}
+
+// Whole pixels, so the bars and the frame meet without a seam
+QRect HudMirror::target() const
+{
+    if (m_sourceSize.isEmpty() || m_scaling == Stretch) return rect();
+    const qreal s = qMin(width() / qreal(m_sourceSize.width()), height() / qreal(m_sourceSize.height()));
+    const int w = qRound(m_sourceSize.width() * s), h = qRound(m_sourceSize.height() * s);
+    return QRect((width() - w) / 2, (height() - h) / 2, w, h);
+}
+
+// Source rects in window coordinates, a pixel wider for the filter
+QRegion HudMirror::toWindow(const QRegion &source) const
+{
+    const QRectF t = target();
+    const qreal sx = t.width() / m_sourceSize.width(), sy = t.height() / m_sourceSize.height();
+    QRegion out;
+    for (const QRect &rc : source)
+        out += QRectF(t.x() + rc.x() * sx, t.y() + rc.y() * sy, rc.width() * sx, rc.height() * sy)
+                   .toAlignedRect().adjusted(-1, -1, 1, 1);
+    return out;
+}
+
+void HudMirror::sourceUpdated(const QImage &frame, const QSize &logicalSize, const QRegion &changed)
+{
+    const bool whole = m_source != &frame || m_sourceSize != logicalSize;
+    m_source = &frame;
+    m_sourceSize = logicalSize;
+    if (m_sourceSize.isEmpty()) return;
+
+    if (!m_warp) {
+        if (whole) update();
+        else update(toWindow(changed));
+        return;
+    }
+
+    // Warped: repaint where the changed source lands, re-warp on paint
+    m_warpSrcDirty += whole ? QRegion(QRect(QPoint(), logicalSize)) : changed;
+    if (whole || !m_remap.isValid() || m_remap.srcWidth() != frame.width() || m_remap.srcHeight() != frame.height()) {
+        update();
+        return;
+    }
+    const qreal s = frame.devicePixelRatio(), o = m_warpOut.devicePixelRatio();
+    QRegion out;
+    for (const QRect &rc : changed) {
+        const QRect sr = QRectF(rc.x() * s, rc.y() * s, rc.width() * s, rc.height() * s).toAlignedRect();
+        const WarpRemap::Rect f = m_remap.footprint(WarpRemap::Rect{ sr.left(), sr.top(), sr.right() + 1, sr.bottom() + 1 },
+                                                    nullptr);
+        if (f.x1 > f.x0)
+            out += QRectF(f.x0 / o, f.y0 / o, (f.x1 - f.x0) / o, (f.y1 - f.y0) / o).toAlignedRect();
+    }
+    update(out);
+}
+
+// Rebuilds the remap when the window or the source changed size; true if it did
+bool HudMirror::updateRemap()
+{
+    const qreal dpr = devicePixelRatioF();
+    const QSize out = (QSizeF(size()) * dpr).toSize();
+    if (m_remap.isValid() && m_remap.outWidth() == out.width() && m_remap.outHeight() == out.height() &&
+        m_remap.srcWidth() == m_source->width() && m_remap.srcHeight() == m_source->height())
+        return false;
+
+    m_remap.build(m_warpMesh, out.width(), out.height(), m_source->width(), m_source->height());
+    m_warpOut = QImage(out, QImage::Format_RGB32);
+    m_warpOut.setDevicePixelRatio(dpr);
+    m_warpOut.fill(Qt::black);
+    return true;
+}
+
+// Re-warps the tiles that read the changed source (on the GUI thread; a
+// mirror is usually a monitor, the HUD's own warp keeps the worker pool)
+void HudMirror::warpChanged()
+{
+    m_warpMask.assign(size_t(m_remap.tilesX()) * m_remap.tilesY(), 0);
+    const qreal s = m_source->devicePixelRatio();
+    for (const QRect &rc : m_warpSrcDirty) {
+        const QRect sr = QRectF(rc.x() * s, rc.y() * s, rc.width() * s, rc.height() * s).toAlignedRect();
+        m_remap.footprint(WarpRemap::Rect{ sr.left(), sr.top(), sr.right() + 1, sr.bottom() + 1 }, m_warpMask.data());
+    }
+    m_warpSrcDirty = QRegion();
+
+    m_remap.apply(reinterpret_cast<const uint32_t *>(m_source->constBits()), m_source->bytesPerLine() / 4,
+                  reinterpret_cast<uint32_t *>(m_warpOut.bits()), m_warpOut.bytesPerLine() / 4,
+                  0, m_remap.tilesY(), m_warpMask.data());
+}
+
+void HudMirror::paintEvent(QPaintEvent *event)
+{
+    QPainter p(this);
+    if (!m_source || m_source->isNull() || m_sourceSize.isEmpty()) {
+        for (const QRect &rc : event->region())
+            p.fillRect(rc, Qt::black);
+        return;
+    }
+
+    if (m_warp) {
+        if (updateRemap()) m_warpSrcDirty = QRect(QPoint(), m_sourceSize);
+        if (!m_warpSrcDirty.isEmpty()) warpChanged();
+        const qreal o = m_warpOut.devicePixelRatio();
+        for (const QRect &rc : event->region())
+            p.drawImage(QRectF(rc), m_warpOut, QRectF(rc.x() * o, rc.y() * o, rc.width() * o, rc.height() * o));
+        return;
+    }
+
+    // Bars around a fitted frame
+    const QRectF t = target();
+    for (const QRect &rc : event->region() - QRegion(target()))
+        p.fillRect(rc, Qt::black);
+
+    // Each requested rect from the matching part of the frame
+    p.setRenderHint(QPainter::SmoothPixmapTransform, true);
+    const qreal sx = m_source->width() / t.width(), sy = m_source->height() / t.height();
+    for (const QRect &rc : event->region()) {
+        const QRectF w = QRectF(rc) & t;
+        if (w.isEmpty()) continue;
+        p.drawImage(w, *m_source, QRectF((w.x() - t.x()) * sx, (w.y() - t.y()) * sy, w.width() * sx, w.height() * sy));
+    }
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include <QImage>
+#include <QRegion>
+#include <QWidget>
+#include "WarpMesh.h"
+#include "WarpRemap.h"
+
+// A window showing the frame a HudWidget painted, on another screen.
+//
+// The HUD renders once into its offscreen frame and calls sourceUpdated()
+// with what it repainted. The mirror reads that frame in place (it keeps a
+// pointer, not a copy, so the HUD's next paint doesn't detach it) and only
+// repaints the matching part of its window: a scaled blit, or a re-warp of
+// the tiles that read it. Changes pile up until the mirror gets to paint,
+// so a mirror that falls behind shows the newest frame, complete.
+//
+// Scaling: Fit keeps the HUD's aspect (black bars), Stretch fills the
+// window. With a warp mesh the mesh places the frame and scaling is unused.
+class HudMirror : public QWidget {
+    Q_OBJECT
+public:
+    enum Scaling { Fit, Stretch };
+
+    explicit HudMirror(QWidget *parent = nullptr);
+
+    void setScaling(Scaling scaling);
+    Scaling scaling() const { return m_scaling; }
+
+    // An invalid mesh turns the warp off
+    void setWarp(const WarpMesh &mesh);
+    bool warpEnabled() const { return m_warp; }
+
+    // From the HUD after each paint. frame stays valid (and is only written
+    // by the HUD's next paint); logicalSize is the HUD's size, changed is in
+    // its logical coordinates.
+    void sourceUpdated(const QImage &frame, const QSize &logicalSize, const QRegion &changed);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+
+private:
+    QRect   target() const;                  // where the frame lands, logical
+    QRegion toWindow(const QRegion &source) const;
+    bool    updateRemap();
+    void    warpChanged();
+
+    const QImage *m_source = nullptr;
+    QSize   m_sourceSize;                    // HUD logical size
+    Scaling m_scaling = Fit;
+
+    WarpMesh  m_warpMesh;
+    WarpRemap m_remap;
+    QImage    m_warpOut;                     // window device pixels
+    QRegion   m_warpSrcDirty;                // source not yet re-warped
+    std::vector<uint8_t> m_warpMask;
+    bool      m_warp = false;
+};
@@ -0,0 +1,368 @@
+#include "HudQuickItems.h"
+#include "AttitudeRenderer.h"
+#include "FastMath.h"
+#include "HudSample.h"
+#include "HudTapes.h"
+#include "HudText.h"
+
+#include <QFont>
+#include <QHash>
+#include <QImage>
+#include <QMatrix4x4>
+#include <QPainter>
+#include <QQuickWindow>
+#include <QSGImageNode>
+#include <QSGNode>
+#include <QSGTexture>
+#include <QtMath>
+
+#include <climits>
+#include <cmath>
+
+// ---------------------------------------------------------------------------
+// HudQuickModel
+
+static QString degreeString(double deg)
+{
+    char buf[32];
+    int n = formatFixed(buf, qRound64(deg * 10.0) / 10.0, 1);
+    buf[n++] = '\xB0';   // Latin-1 degree sign
+    return QString::fromLatin1(buf, n);
+}
+
+void HudQuickModel::setSample(const HudSample& s)
+{
+    setAttitude(s.headingDeg, s.rollDeg, s.pitchDeg);
+    if (s.altitudeFt != m_altitudeFt || s.vspeedFpm != m_vspeedFpm) {
+        m_altitudeFt = s.altitudeFt;
+        m_vspeedFpm = s.vspeedFpm;
+        emit altitudeChanged();
+    }
+}
+
+void HudQuickModel::setAttitude(double headingDeg, double rollDeg, double pitchDeg)
+{
+    headingDeg = fastWrap360(headingDeg);
+    if (headingDeg == m_headingDeg && rollDeg == m_rollDeg && pitchDeg == m_pitchDeg) return;
+    m_headingDeg = headingDeg;
+    m_rollDeg = rollDeg;
+    m_pitchDeg = pitchDeg;
+    emit attitudeChanged();
+}
+
+QString HudQuickModel::headingText() const { return degreeString(m_headingDeg); }
+QString HudQuickModel::rollText() const    { return degreeString(m_rollDeg); }
+QString HudQuickModel::pitchText() const   { return degreeString(m_pitchDeg); }
+
+QString HudQuickModel::altitudeText() const
+{
+    char buf[32];
+    return QString::fromLatin1(buf, formatInt(buf, qRound64(m_altitudeFt)));
+}
+
+QString HudQuickModel::vspeedText() const
+{
+    char buf[32];
+    const int n = formatInt(buf, qRound64(m_vspeedFpm));
+    return QString::fromLatin1(buf, n) + QStringLiteral(" FPM");
+}
+
+// ---------------------------------------------------------------------------
+// Shared node helpers (render thread)
+
+// Paint into a transparent image at the window's DPR and upload it
+template <typename Paint>
+static QSGTexture* paintTexture(QQuickWindow* win, const QSizeF& size, qreal dpr,
+                                double pointSize, Paint paint)
+{
+    QImage img(qMax(1, qCeil(size.width() * dpr)), qMax(1, qCeil(size.height() * dpr)),
+               QImage::Format_ARGB32_Premultiplied);
+    img.setDevicePixelRatio(dpr);
+    img.fill(Qt::transparent);
+
+    QPainter p(&img);
+    p.setRenderHint(QPainter::Antialiasing, true);
+    p.setRenderHint(QPainter::TextAntialiasing, true);
+    QFont f;
+    f.setPointSizeF(pointSize);
+    p.setFont(f);
+    paint(p);
+    p.end();
+
+    return win->createTextureFromImage(img);
+}
+
+static QSGImageNode* imageNode(QQuickWindow* win)
+{
+    QSGImageNode* n = win->createImageNode();
+    n->setOwnsTexture(false);
+    n->setFiltering(QSGTexture::Linear);
+    return n;
+}
+
+static double snap(double v, qreal dpr)
+{
+    return std::round(v * dpr) / dpr;
+}
+
+// ---------------------------------------------------------------------------
+// HudTapeItem
+
+namespace {
+
+struct TapeNode : QSGClipNode
+{
+    QSGTransformNode* scroll = nullptr;
+    QVector<QSGImageNode*> images;
+    QHash<int, QSGTexture*> textures;   // heading: tile index, altitude: band
+    QSizeF size;
+    qreal  dpr = 0.0;
+    double pointSize = 0.0;
+    int    kind = -1;
+    int    shownBand = INT_MIN;
+
+    ~TapeNode() override { qDeleteAll(textures); }
+
+    void reset()
+    {
+        qDeleteAll(textures);
+        textures.clear();
+        shownBand = INT_MIN;
+    }
+};
+
+} // namespace
+
+HudTapeItem::HudTapeItem(QQuickItem* parent) : QQuickItem(parent)
+{
+    setFlag(ItemHasContents, true);
+}
+
+void HudTapeItem::setKind(Kind k)
+{
+    if (k == m_kind) return;
+    m_kind = k;
+    emit kindChanged();
+    update();
+}
+
+void HudTapeItem::setValue(double v)
+{
+    if (v == m_value) return;
+    m_value = v;
+    emit valueChanged();
+    update();
+}
+
+void HudTapeItem::setLabelPointSize(double pt)
+{
+    if (pt == m_labelPointSize) return;
+    m_labelPointSize = pt;
+    emit labelPointSizeChanged();
+    update();
+}
+
+QSGNode* HudTapeItem::updatePaintNode(QSGNode* old, UpdatePaintNodeData*)
+{
+    const QSizeF size = boundingRect().size();
+    if (size.isEmpty()) {
+        delete old;
+        return nullptr;
+    }
+
+    QQuickWindow* win = window();
+    const qreal dpr = win->effectiveDevicePixelRatio();
+    TapeNode* node = static_cast<TapeNode*>(old);
+    if (!node) {
+        node = new TapeNode;
+        node->setIsRectangular(true);
+        node->scroll = new QSGTransformNode;
+        node->appendChildNode(node->scroll);
+    }
+    node->setClipRect(boundingRect());
+
+    const double w = size.width(), h = size.height();
+    const bool rebuild = node->size != size || node->dpr != dpr ||
+                         node->pointSize != m_labelPointSize || node->kind != m_kind;
+    if (rebuild) {
+        node->reset();
+        node->size = size;
+        node->dpr = dpr;
+        node->pointSize = m_labelPointSize;
+        node->kind = m_kind;
+        qDeleteAll(node->images);   // also unparents
+        node->images.clear();
+    }
+
+    QMatrix4x4 m;
+    if (m_kind == Heading) {
+        if (rebuild) {
+            // Six tiles plus tile 0 again, so any 60-degree window is contiguous
+            for (int i = 0; i < HeadingStrip::kTiles; ++i)
+                node->textures.insert(i, paintTexture(win, size, dpr, m_labelPointSize,
+                    [&](QPainter& p) { HeadingStrip::paintTile(p, i, w, h); }));
+            for (int i = 0; i <= HeadingStrip::kTiles; ++i) {
+                QSGImageNode* img = imageNode(win);
+                img->setTexture(node->textures.value(i % HeadingStrip::kTiles));
+                img->setRect(QRectF(i * w, 0, w, h));
+                node->scroll->appendChildNode(img);
+                node->images.append(img);
+            }
+        }
+        const double left = fastWrap360(m_value - HeadingStrip::kSpanDeg / 2.0);
+        m.translate(-snap(left * w / HeadingStrip::kSpanDeg, dpr), 0);
+    } else {
+        if (rebuild) {
+            for (int i = 0; i < 2; ++i) {
+                QSGImageNode* img = imageNode(win);
+                img->setRect(QRectF(0, i * h, w, h));
+                node->scroll->appendChildNode(img);
+                node->images.append(img);
+            }
+        }
+
+        // Window top is alt + 500 ft: band k on top, band k-1 below it
+        const double topAlt = m_value + AltitudeStrip::kBandFt / 2.0;
+        const int k = (int)std::floor(topAlt / AltitudeStrip::kBandFt);
+        if (k != node->shownBand) {
+            // Keep the bands nearest k
+            for (auto it = node->textures.begin(); it != node->textures.end(); ) {
+                if (qAbs(it.key() - k) > 2) { delete it.value(); it = node->textures.erase(it); }
+                else ++it;
+            }
+            for (int i = 0; i < 2; ++i) {
+                const int band = k - i;
+                QSGTexture* t = node->textures.value(band);
+                if (!t) {
+                    t = paintTexture(win, size, dpr, m_labelPointSize,
+                        [&](QPainter& p) { AltitudeStrip::paintBand(p, band, w, h); });
+                    node->textures.insert(band, t);
+                }
+                node->images[i]->setTexture(t);
+            }
+            node->shownBand = k;
+        }
+        const double offset = ((k + 1) * double(AltitudeStrip::kBandFt) - topAlt) * h / AltitudeStrip::kBandFt;
+        m.translate(0, -snap(offset, dpr));
+    }
+    node->scroll->setMatrix(m);
+    return node;
+}
+
+// ---------------------------------------------------------------------------
+// HudAttitudeItem
+
+namespace {
+
+struct AttitudeNode : QSGClipNode
+{
+    QSGTransformNode* xf = nullptr;
+    QSGImageNode* sprite = nullptr;
+    QSGImageNode* bezel = nullptr;
+    QSGTexture* spriteTex = nullptr;
+    QSGTexture* bezelTex = nullptr;
+    QSizeF size;
+    qreal  dpr = 0.0;
+    double pointSize = 0.0;
+
+    ~AttitudeNode() override
+    {
+        delete spriteTex;
+        delete bezelTex;
+    }
+};
+
+} // namespace
+
+HudAttitudeItem::HudAttitudeItem(QQuickItem* parent) : QQuickItem(parent)
+{
+    setFlag(ItemHasContents, true);
+}
+
+void HudAttitudeItem::setRollDeg(double d)
+{
+    if (d == m_rollDeg) return;
+    m_rollDeg = d;
+    emit attitudeChanged();
+    update();
+}
+
+void HudAttitudeItem::setPitchDeg(double d)
+{
+    if (d == m_pitchDeg) return;
+    m_pitchDeg = d;
+    emit attitudeChanged();
+    update();
+}
+
+void HudAttitudeItem::setLadderPointSize(double pt)
+{
+    if (pt == m_ladderPointSize) return;
+    m_ladderPointSize = pt;
+    emit ladderPointSizeChanged();
+    update();
+}
+
+QSGNode* HudAttitudeItem::updatePaintNode(QSGNode* old, UpdatePaintNodeData*)
+{
+    const QSizeF size = boundingRect().size();
+    if (size.isEmpty()) {
+        delete old;
+        return nullptr;
+    }
+
+    QQuickWindow* win = window();
+    const qreal dpr = win->effectiveDevicePixelRatio();
+    // Outline pen half-width + AA fringe outside the circle rect
+    const QRectF outer = boundingRect().adjusted(-3, -3, 3, 3);
+
+    AttitudeNode* node = static_cast<AttitudeNode*>(old);
+    if (!node) {
+        node = new AttitudeNode;
+        node->setIsRectangular(true);
+        node->xf = new QSGTransformNode;
+        node->sprite = imageNode(win);
+        node->bezel = imageNode(win);
+        node->xf->appendChildNode(node->sprite);
+        node->appendChildNode(node->xf);
+        node->appendChildNode(node->bezel);
+    }
+    node->setClipRect(outer);
+
+    const AttitudeRenderer::SpriteGeometry g = AttitudeRenderer::spriteGeometry(size);
+    if (node->size != size || node->dpr != dpr || node->pointSize != m_ladderPointSize) {
+        delete node->spriteTex;
+        delete node->bezelTex;
+        node->spriteTex = paintTexture(win, QSizeF(g.width, g.height), dpr, m_ladderPointSize,
+            [&](QPainter& p) { AttitudeRenderer::paintSprite(p, size); });
+
+        // Black outside the circle, clear inside, then outline + marker
+        node->bezelTex = paintTexture(win, outer.size(), dpr, m_ladderPointSize, [&](QPainter& p) {
+            const QRectF circle(-outer.topLeft(), size);
+            p.fillRect(QRectF(QPointF(0, 0), outer.size()), Qt::black);
+            p.setCompositionMode(QPainter::CompositionMode_Clear);
+            p.setPen(Qt::NoPen);
+            p.setBrush(Qt::black);
+            p.drawEllipse(circle);
+            p.setCompositionMode(QPainter::CompositionMode_SourceOver);
+            AttitudeRenderer::paintReference(p, circle);
+        });
+
+        node->sprite->setTexture(node->spriteTex);
+        node->sprite->setRect(QRectF(0, 0, g.width, g.height));
+        node->bezel->setTexture(node->bezelTex);
+        node->bezel->setRect(outer);
+        node->size = size;
+        node->dpr = dpr;
+        node->pointSize = m_ladderPointSize;
+    }
+
+    // Roll around the center; the sprite line at -pitch lands on the center
+    const double pitch = qBound(-90.0, m_pitchDeg, 90.0);
+    QMatrix4x4 m;
+    m.translate(size.width() / 2.0, size.height() / 2.0);
+    m.rotate(-m_rollDeg, 0, 0, 1); // negative to match typical aircraft convention
+    m.translate(-g.width / 2.0, -(g.horizonY + pitch * g.pxPerDeg));
+    node->xf->setMatrix(m);
+    return node;
+}
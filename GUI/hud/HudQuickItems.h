@@ -0,0 +1,119 @@
+#pragma once
+#include <QObject>
+#include <QQuickItem>
+#include <QString>
+
+struct HudSample;
+
+// Values the QML HUD binds to. Lives on the GUI thread; the items below
+// only copy numbers out of it, all drawing happens in retained nodes.
+class HudQuickModel : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(double headingDeg READ headingDeg NOTIFY attitudeChanged)
+    Q_PROPERTY(double rollDeg READ rollDeg NOTIFY attitudeChanged)
+    Q_PROPERTY(double pitchDeg READ pitchDeg NOTIFY attitudeChanged)
+    Q_PROPERTY(double altitudeFt READ altitudeFt NOTIFY altitudeChanged)
+    Q_PROPERTY(QString headingText READ headingText NOTIFY attitudeChanged)
+    Q_PROPERTY(QString rollText READ rollText NOTIFY attitudeChanged)
+    Q_PROPERTY(QString pitchText READ pitchText NOTIFY attitudeChanged)
+    Q_PROPERTY(QString altitudeText READ altitudeText NOTIFY altitudeChanged)
+    Q_PROPERTY(QString vspeedText READ vspeedText NOTIFY altitudeChanged)
+public:
+    using QObject::QObject;
+
+    void setSample(const HudSample& s);
+    // Display-time extrapolated attitude (see AttitudePredictor)
+    void setAttitude(double headingDeg, double rollDeg, double pitchDeg);
+
+    double headingDeg() const { return m_headingDeg; }
+    double rollDeg() const    { return m_rollDeg; }
+    double pitchDeg() const   { return m_pitchDeg; }
+    double altitudeFt() const { return m_altitudeFt; }
+
+    // Same rounding as the HudWidget readouts
+    QString headingText() const;
+    QString rollText() const;
+    QString pitchText() const;
+    QString altitudeText() const;
+    QString vspeedText() const;
+
+signals:
+    void attitudeChanged();
+    void altitudeChanged();
+
+private:
+    double m_headingDeg = 0.0;
+    double m_rollDeg    = 0.0;
+    double m_pitchDeg   = 0.0;
+    double m_altitudeFt = 0.0;
+    double m_vspeedFpm  = 0.0;
+};
+
+// Heading or altitude tape. Strip textures are rendered once per size
+// (HeadingStrip / AltitudeStrip tile painters); a value change only moves
+// a transform node.
+class HudTapeItem : public QQuickItem
+{
+    Q_OBJECT
+    Q_PROPERTY(Kind kind READ kind WRITE setKind NOTIFY kindChanged)
+    Q_PROPERTY(double value READ value WRITE setValue NOTIFY valueChanged)
+    Q_PROPERTY(double labelPointSize READ labelPointSize WRITE setLabelPointSize NOTIFY labelPointSizeChanged)
+public:
+    enum Kind { Heading, Altitude };
+    Q_ENUM(Kind)
+
+    explicit HudTapeItem(QQuickItem* parent = nullptr);
+
+    Kind kind() const { return m_kind; }
+    void setKind(Kind k);
+    double value() const { return m_value; }
+    void setValue(double v);
+    double labelPointSize() const { return m_labelPointSize; }
+    void setLabelPointSize(double pt);
+
+signals:
+    void kindChanged();
+    void valueChanged();
+    void labelPointSizeChanged();
+
+protected:
+    QSGNode* updatePaintNode(QSGNode* old, UpdatePaintNodeData*) override;
+
+private:
+    Kind   m_kind = Heading;
+    double m_value = 0.0;
+    double m_labelPointSize = 10.0;
+};
+
+// Attitude ball: the ladder sprite under a rotate/translate transform node,
+// then a bezel texture (black outside the circle, outline, aircraft marker).
+// Masking by overdraw keeps it to nodes the software backend supports.
+class HudAttitudeItem : public QQuickItem
+{
+    Q_OBJECT
+    Q_PROPERTY(double rollDeg READ rollDeg WRITE setRollDeg NOTIFY attitudeChanged)
+    Q_PROPERTY(double pitchDeg READ pitchDeg WRITE setPitchDeg NOTIFY attitudeChanged)
+    Q_PROPERTY(double ladderPointSize READ ladderPointSize WRITE setLadderPointSize NOTIFY ladderPointSizeChanged)
+public:
+    explicit HudAttitudeItem(QQuickItem* parent = nullptr);
+
+    double rollDeg() const { return m_rollDeg; }
+    void setRollDeg(double d);
+    double pitchDeg() const { return m_pitchDeg; }
+    void setPitchDeg(double d);
+    double ladderPointSize() const { return m_ladderPointSize; }
+    void setLadderPointSize(double pt);
+
+signals:
+    void attitudeChanged();
+    void ladderPointSizeChanged();
+
+protected:
+    QSGNode* updatePaintNode(QSGNode* old, UpdatePaintNodeData*) override;
+
+private:
+    double m_rollDeg = 0.0;
+    double m_pitchDeg = 0.0;
+    double m_ladderPointSize = 10.0;
+};
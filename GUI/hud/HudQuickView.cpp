@@ -0,0 +1,55 @@
+#include "HudQuickView.h"
+#include "AttitudePredictor.h"
+
+#include <QQmlContext>
+#include <QQmlEngine>
+#include <QtQml>
+
+void HudQuickView::registerTypes()
+{
+    static bool done = false;
+    if (done) return;
+    done = true;
+    qmlRegisterType<HudTapeItem>("Pegasus.Hud", 1, 0, "HudTape");
+    qmlRegisterType<HudAttitudeItem>("Pegasus.Hud", 1, 0, "HudAttitude");
+}
+
+HudQuickView::HudQuickView(QWindow* parent) : QQuickView(parent)
+{
+    registerTypes();
+    setColor(Qt::black);
+    setResizeMode(QQuickView::SizeRootObjectToView);
+    rootContext()->setContextProperty("hud", &m_model);
+    setSource(QUrl(QStringLiteral("qrc:/Hud.qml")));
+
+    // Predicted attitude is applied before the scene is synchronized
+    connect(this, &QQuickWindow::afterAnimating, this, [this]() {
+        if (!m_predictor || !m_predictor->hasSample()) return;
+        const AttitudePredictor::Attitude a = m_predictor->predict(AttitudePredictor::steadyNowUs());
+        m_model.setAttitude(a.headingDeg, a.rollDeg, a.pitchDeg);
+    });
+
+    // Sync (updatePaintNode) + render, timed on the render thread
+    connect(this, &QQuickWindow::beforeSynchronizing, this, [this]() {
+        m_frameTimer.start();
+    }, Qt::DirectConnection);
+    connect(this, &QQuickWindow::afterRendering, this, [this]() {
+        const double us = m_frameTimer.nsecsElapsed() / 1000.0;
+        QMutexLocker lock(&m_statsLock);
+        ++m_frames;
+        m_sumUs += us;
+        if (us > m_maxUs) m_maxUs = us;
+    }, Qt::DirectConnection);
+}
+
+HudQuickView::FrameStats HudQuickView::takeFrameStats()
+{
+    QMutexLocker lock(&m_statsLock);
+    FrameStats st;
+    st.frames = m_frames;
+    st.meanUs = m_frames ? m_sumUs / m_frames : 0.0;
+    st.maxUs  = m_maxUs;
+    m_frames = 0;
+    m_sumUs = m_maxUs = 0.0;
+    return st;
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QQuickView>
+
+#include "HudQuickItems.h"
+
+class AttitudePredictor;
+
+// HUD on the QtQuick scene graph (qml/Hud.qml). Works with the threaded
+// render loop and with QT_QUICK_BACKEND=software; frame stats are measured
+// on the render thread (sync + render) so they line up with
+// HudWidget::takePaintStats().
+class HudQuickView : public QQuickView
+{
+    Q_OBJECT
+public:
+    explicit HudQuickView(QWindow* parent = nullptr);
+
+    HudQuickModel* model() { return &m_model; }
+
+    void setSample(const HudSample& s) { m_model.setSample(s); }
+    // Replace the sample attitude with the display-time prediction each frame
+    void setPredictor(AttitudePredictor* p) { m_predictor = p; }
+
+    struct FrameStats {
+        int    frames = 0;
+        double meanUs = 0.0;
+        double maxUs = 0.0;
+    };
+    FrameStats takeFrameStats();
+
+    // "Pegasus.Hud" 1.0: HudTape, HudAttitude (done by the constructor)
+    static void registerTypes();
+
+private:
+    HudQuickModel m_model;
+    AttitudePredictor* m_predictor = nullptr;
+
+    // Render thread
+    QElapsedTimer m_frameTimer;
+
+    QMutex m_statsLock;
+    int    m_frames = 0;
+    double m_sumUs = 0.0;
+    double m_maxUs = 0.0;
+};
@@ -17,4 +17,6 @@ struct HudSample {
     double tempC = 0;
 
     long long tsMs = 0;
+    long long tsUs = 0;   // device clock (ts_us), 0 if the source has none
+    long long hostUs = 0; // host steady clock at arrival, 0 if not stamped
 };
@@ -0,0 +1,13 @@
+#pragma once
+#include <QColor>
+#include <QPen>
+
+// Stroke used by every HUD instrument
+inline QPen hudPen(double w = 2.0)
+{
+    QPen pen(QColor(230, 230, 230));
+    pen.setWidthF(w);
+    pen.setCapStyle(Qt::RoundCap);
+    pen.setJoinStyle(Qt::RoundJoin);
+    return pen;
+}
@@ -0,0 +1,188 @@
+#include "HudTapes.h"
+#include "HudStyle.h"
+#include "FastMath.h"
+
+#include <QPainter>
+#include <QtMath>
+#include <cmath>
+
+// Snap a logical coordinate to the device pixel grid
+static double snap(double v, qreal dpr)
+{
+    return std::round(v * dpr) / dpr;
+}
+
+// ---------------------------------------------------------------------------
+// HeadingStrip
+
+void HeadingStrip::configure(const QSizeF& inner, qreal dpr, const QFont& labelFont)
+{
+    if (inner == m_size && dpr == m_dpr && labelFont == m_font && !m_tiles[0].isNull())
+        return;
+
+    m_size = inner;
+    m_dpr = dpr;
+    m_font = labelFont;
+    m_tileW = qMax(1, qRound(inner.width() * dpr));
+    m_tileH = qMax(1, qRound(inner.height() * dpr));
+    for (int i = 0; i < kTiles; ++i) renderTile(i);
+}
+
+void HeadingStrip::renderTile(int i)
+{
+    QImage& tile = m_tiles[i];
+    tile = QImage(m_tileW, m_tileH, QImage::Format_ARGB32_Premultiplied);
+    tile.setDevicePixelRatio(m_dpr);
+    tile.fill(Qt::transparent);
+
+    QPainter p(&tile);
+    p.setRenderHint(QPainter::Antialiasing, true);
+    p.setRenderHint(QPainter::TextAntialiasing, true);
+    p.setFont(m_font);
+    paintTile(p, i, m_tileW / m_dpr, m_tileH / m_dpr);
+}
+
+void HeadingStrip::paintTile(QPainter& p, int i, double w, double h)
+{
+    const double pxPerDeg = w / kSpanDeg;
+    const int first = i * int(kSpanDeg);
+    p.setPen(hudPen(2.0));
+
+    // ticks every 5 degrees, longer every 10; overlap the neighbours so
+    // strokes and labels straddling a tile edge come out whole
+    for (int deg = first - 10; deg <= first + int(kSpanDeg) + 10; deg += 5) {
+        const double x = (deg - first) * pxPerDeg;
+        const double tickH = (deg % 10 == 0) ? h*0.55 : h*0.35;
+        p.drawLine(QPointF(x, h), QPointF(x, h - tickH));
+
+        // labels for cardinal-ish around (simple)
+        if (deg % 30 == 0) {
+            const int d = (deg + 360) % 360;
+            const QString label = (d == 0) ? QStringLiteral("N") : (d == 90) ? QStringLiteral("E") :
+                                  (d == 180) ? QStringLiteral("S") : (d == 270) ? QStringLiteral("W") :
+                                  QString::number(d);
+            p.drawText(QRectF(x-20, 0, 40, h*0.6), Qt::AlignHCenter | Qt::AlignVCenter, label);
+        }
+    }
+}
+
+int HeadingStrip::offsetPx(double centerDeg) const
+{
+    if (m_tileW <= 0) return 0;
+
+    // Left edge of the window, in device pixels into the 360-degree strip
+    const double left = fastWrap360(centerDeg - kSpanDeg / 2.0);
+    return qRound(left * (m_tileW / kSpanDeg)) % (m_tileW * kTiles);
+}
+
+void HeadingStrip::draw(QPainter& p, const QRectF& inner, double centerDeg) const
+{
+    if (m_tiles[0].isNull()) return;
+
+    int offset = offsetPx(centerDeg);
+    int tile = offset / m_tileW;
+    offset -= tile * m_tileW;
+    tile %= kTiles;
+
+    const double x0 = snap(inner.left(), m_dpr);
+    const double y0 = snap(inner.top(), m_dpr);
+    const double h = m_tileH / m_dpr;
+
+    const int head = m_tileW - offset;   // device px taken from `tile`
+    p.drawImage(QRectF(x0, y0, head / m_dpr, h), m_tiles[tile],
+                QRectF(offset, 0, head, m_tileH));
+    if (offset > 0)
+        p.drawImage(QRectF(x0 + head / m_dpr, y0, offset / m_dpr, h), m_tiles[(tile + 1) % kTiles],
+                    QRectF(0, 0, offset, m_tileH));
+}
+
+// ---------------------------------------------------------------------------
+// AltitudeStrip
+
+void AltitudeStrip::configure(const QSizeF& inner, qreal dpr, const QFont& labelFont)
+{
+    if (inner == m_size && dpr == m_dpr && labelFont == m_font)
+        return;
+
+    m_size = inner;
+    m_dpr = dpr;
+    m_font = labelFont;
+    m_bandW = qMax(1, qRound(inner.width() * dpr));
+    m_bandH = qMax(1, qRound(inner.height() * dpr));
+    m_bands.clear();
+}
+
+const QImage& AltitudeStrip::band(int k)
+{
+    auto it = m_bands.constFind(k);
+    if (it != m_bands.constEnd()) return it.value();
+
+    // Keep the bands closest to the one being asked for
+    while (m_bands.size() >= kMaxBands) {
+        auto far = m_bands.begin();
+        for (auto b = m_bands.begin(); b != m_bands.end(); ++b)
+            if (qAbs(b.key() - k) > qAbs(far.key() - k)) far = b;
+        m_bands.erase(far);
+    }
+
+    QImage img(m_bandW, m_bandH, QImage::Format_ARGB32_Premultiplied);
+    img.setDevicePixelRatio(m_dpr);
+    img.fill(Qt::transparent);
+
+    QPainter p(&img);
+    p.setRenderHint(QPainter::Antialiasing, true);
+    p.setRenderHint(QPainter::TextAntialiasing, true);
+    p.setFont(m_font);
+    paintBand(p, k, m_bandW / m_dpr, m_bandH / m_dpr);
+    p.end();
+
+    return *m_bands.insert(k, img);
+}
+
+void AltitudeStrip::paintBand(QPainter& p, int k, double w, double h)
+{
+    const double pxPerFt = h / kBandFt;
+    const int top = (k + 1) * kBandFt;   // altitude at y = 0
+    p.setPen(hudPen(2.0));
+
+    // ticks every 50 ft, long every 100/200; overlap the neighbours for
+    // strokes and labels that straddle a band edge
+    for (int alt = k * kBandFt - 100; alt <= top + 100; alt += 50) {
+        const double y = (top - alt) * pxPerFt;
+        const bool major = (alt % 200 == 0);
+        const bool med   = (alt % 100 == 0);
+        const double tickLen = major ? w*0.55 : (med ? w*0.40 : w*0.25);
+        p.drawLine(QPointF(w - tickLen, y), QPointF(w, y));
+
+        if (med)
+            p.drawText(QRectF(0, y-10, w*0.60, 20), Qt::AlignLeft | Qt::AlignVCenter,
+                       QString::number(alt));
+    }
+}
+
+qint64 AltitudeStrip::offsetPx(double altitudeFt) const
+{
+    return qRound64((altitudeFt + kBandFt / 2.0) * (double(m_bandH) / kBandFt));
+}
+
+void AltitudeStrip::draw(QPainter& p, const QRectF& inner, double altitudeFt)
+{
+    if (m_bandH <= 0) return;
+
+    // Window top is alt + 500 ft; find its band and device-pixel offset
+    const double topAlt = altitudeFt + kBandFt / 2.0;
+    const int k = (int)std::floor(topAlt / kBandFt);
+    const double pxPerFt = double(m_bandH) / kBandFt;
+    const int offset = qBound(0, qRound(((k + 1) * double(kBandFt) - topAlt) * pxPerFt), m_bandH);
+
+    const double x0 = snap(inner.left(), m_dpr);
+    const double y0 = snap(inner.top(), m_dpr);
+    const double w = m_bandW / m_dpr;
+
+    const int head = m_bandH - offset;   // device px taken from band k
+    if (head > 0)
+        p.drawImage(QRectF(x0, y0, w, head / m_dpr), band(k), QRectF(0, offset, m_bandW, head));
+    if (offset > 0)
+        p.drawImage(QRectF(x0, y0 + head / m_dpr, w, offset / m_dpr), band(k - 1),
+                    QRectF(0, 0, m_bandW, offset));
+}
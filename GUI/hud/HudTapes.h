@@ -0,0 +1,67 @@
+#pragma once
+#include <QFont>
+#include <QHash>
+#include <QImage>
+#include <QRectF>
+
+class QPainter;
+
+// Pre-rendered heading scale. The full 0..360 range is split into six
+// 60-degree tiles, each exactly one tape window wide, rendered once per
+// size/DPR/font. A frame blits the tail of one tile and the head of the
+// next at the device-pixel offset of the current heading, so wraparound is
+// just (tile + 1) % 6. Tiles are QImages so a worker thread can draw them.
+class HeadingStrip
+{
+public:
+    static constexpr int kTiles = 6;
+    static constexpr double kSpanDeg = 60.0;   // visible window
+
+    // Cheap when nothing changed; re-renders the tiles otherwise
+    void configure(const QSizeF& inner, qreal dpr, const QFont& labelFont);
+    void draw(QPainter& p, const QRectF& inner, double centerDeg) const;
+
+    // Device-pixel scroll position draw() would use (0 before configure)
+    int offsetPx(double centerDeg) const;
+
+    // Paint tile i into a w x h (logical) area with the painter's font;
+    // shared with the QtQuick renderer
+    static void paintTile(QPainter& p, int i, double w, double h);
+
+private:
+    QImage  m_tiles[kTiles];
+    QSizeF  m_size;
+    qreal   m_dpr = 0.0;
+    QFont   m_font;
+    int     m_tileW = 0, m_tileH = 0;   // device pixels
+
+    void renderTile(int i);
+};
+
+// Pre-rendered altitude scale in 1000 ft bands, each exactly one tape
+// window tall. Bands are rendered on first use and kept for the bands
+// nearest the current altitude; a frame blits from at most two of them.
+class AltitudeStrip
+{
+public:
+    static constexpr int kBandFt = 1000;       // == visible span
+    static constexpr int kMaxBands = 4;
+
+    void configure(const QSizeF& inner, qreal dpr, const QFont& labelFont);
+    void draw(QPainter& p, const QRectF& inner, double altitudeFt);
+
+    // Device-pixel scroll position of the window top (0 before configure)
+    qint64 offsetPx(double altitudeFt) const;
+
+    // Paint band k (altitudes k*1000 .. (k+1)*1000, higher at the top)
+    static void paintBand(QPainter& p, int k, double w, double h);
+
+private:
+    QHash<int, QImage> m_bands;   // key: floor(alt / 1000)
+    QSizeF m_size;
+    qreal  m_dpr = 0.0;
+    QFont  m_font;
+    int    m_bandW = 0, m_bandH = 0;   // device pixels
+
+    const QImage& band(int k);
+};
@@ -0,0 +1,88 @@
+#include "HudText.h"
+#include <QPainter>
+#include <cmath>
+
+int formatInt(char* out, long long v)
+{
+    char tmp[24];
+    int n = 0;
+    unsigned long long u = v < 0 ? 0ULL - (unsigned long long)v : (unsigned long long)v;
+    do {
+        tmp[n++] = char('0' + u % 10);
+        u /= 10;
+    } while (u);
+
+    int len = 0;
+    if (v < 0) out[len++] = '-';
+    while (n) out[len++] = tmp[--n];
+    out[len] = '\0';
+    return len;
+}
+
+int formatFixed(char* out, double v, int decimals)
+{
+    static const long long kScale[] = { 1, 10, 100, 1000, 10000, 100000, 1000000 };
+    if (decimals < 0) decimals = 0;
+    if (decimals > 6) decimals = 6;
+
+    const long long scaled = std::llround(std::fabs(v) * kScale[decimals]);
+    int len = 0;
+    if (v < 0 && scaled != 0) out[len++] = '-';
+    len += formatInt(out + len, scaled / kScale[decimals]);
+    if (decimals > 0) {
+        out[len++] = '.';
+        long long frac = scaled % kScale[decimals];
+        for (int d = decimals - 1; d >= 0; --d) {
+            out[len + d] = char('0' + frac % 10);
+            frac /= 10;
+        }
+        len += decimals;
+    }
+    out[len] = '\0';
+    return len;
+}
+
+void HudTextCache::setFont(const QFont& f)
+{
+    if (f == m_font) return;
+    m_font = f;
+    m_items.clear();
+}
+
+const QStaticText* HudTextCache::find(qint64 key) const
+{
+    auto it = m_items.constFind(key);
+    return it == m_items.constEnd() ? nullptr : &it.value();
+}
+
+const QStaticText& HudTextCache::insert(qint64 key, const QString& text)
+{
+    // Values drift (altitude); start over rather than track LRU
+    if (m_items.size() >= m_capacity) m_items.clear();
+
+    QStaticText t(text);
+    t.setTextFormat(Qt::PlainText);
+    t.setPerformanceHint(QStaticText::AggressiveCaching);
+    t.prepare(QTransform(), m_font);
+    return *m_items.insert(key, t);
+}
+
+const QStaticText& HudTextCache::insert(qint64 key, const char* text, int len)
+{
+    return insert(key, QString::fromLatin1(text, len));
+}
+
+void HudTextCache::draw(QPainter& p, const QRectF& r, int align, const QStaticText& t)
+{
+    const QSizeF s = t.size();
+
+    double x = r.left();
+    if (align & Qt::AlignHCenter)    x = r.center().x() - s.width() / 2.0;
+    else if (align & Qt::AlignRight) x = r.right() - s.width();
+
+    double y = r.top();
+    if (align & Qt::AlignVCenter)     y = r.center().y() - s.height() / 2.0;
+    else if (align & Qt::AlignBottom) y = r.bottom() - s.height();
+
+    p.drawStaticText(QPointF(x, y), t);
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include <QFont>
+#include <QHash>
+#include <QRectF>
+#include <QStaticText>
+
+class QPainter;
+
+// Locale-free number formatting into a caller buffer (no allocation).
+// Return the number of characters written; out needs 24 chars.
+int formatInt(char* out, long long v);
+int formatFixed(char* out, double v, int decimals);   // decimals 0..6, round half away from zero
+
+// Pre-laid-out text for one font. Entries are keyed by an integer the caller
+// derives from the value it displays (tape degree, altitude, tenths of a
+// degree, ...), so the string is only formatted and shaped on a miss; the
+// hit path is a hash lookup plus QPainter::drawStaticText.
+class HudTextCache
+{
+public:
+    explicit HudTextCache(int capacity = 512) : m_capacity(capacity) {}
+
+    // Drops every entry when the font actually changes
+    void setFont(const QFont& f);
+    const QFont& font() const { return m_font; }
+
+    const QStaticText* find(qint64 key) const;
+    const QStaticText& insert(qint64 key, const QString& text);
+    const QStaticText& insert(qint64 key, const char* text, int len);
+
+    int size() const { return m_items.size(); }
+    void clear() { m_items.clear(); }
+
+    // Draw aligned inside r (Qt::Align* flags, like QPainter::drawText).
+    // The painter's font must be font().
+    static void draw(QPainter& p, const QRectF& r, int align, const QStaticText& t);
+
+private:
+    QFont m_font;
+    QHash<qint64, QStaticText> m_items;
+    int m_capacity;
+};
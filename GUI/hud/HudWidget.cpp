@@ -1,8 +1,24 @@
 #include "HudWidget.h"
+#include "AttitudePredictor.h"
+#include "FastMath.h"
+#include "HudMirror.h"
+#include "HudSample.h"
+#include "HudStyle.h"
+#include "QualityGovernor.h"
+#include <QElapsedTimer>
+#include <QEvent>
+#include <QFontMetrics>
+#include <QKeyEvent>
+#include <QPaintEvent>
 #include <QPainter>
-#include <QPainterPath>
+#include <QRunnable>
+#include <QSemaphore>
+#include <QThread>
 #include <QtMath>
 
+#include <algorithm>
+#include <functional>
+
 HudWidget::HudWidget(QWidget *parent) : QWidget(parent)
 {
     setAutoFillBackground(false);
@@ -12,56 +28,887 @@ HudWidget::HudWidget(QWidget *parent) : QWidget(parent)
 
 double HudWidget::wrap360(double deg)
 {
-    deg = std::fmod(deg, 360.0);
-    if (deg < 0) deg += 360.0;
-    return deg;
+    return fastWrap360(deg);
+}
+
+// The single-value setters always repaint their instrument and leave change
+// detection to start over with the next setSample().
+void HudWidget::setHeadingDeg(double deg)  { m_headingDeg = wrap360(deg); m_visualValid = false; markDirty(HeadingInstrument); }
+void HudWidget::setRollDeg(double deg)     { m_rollDeg = deg; m_visualValid = false; markDirty(AttitudeInstrument | ReadoutInstrument); }
+void HudWidget::setPitchDeg(double deg)    { m_pitchDeg = deg; m_visualValid = false; markDirty(AttitudeInstrument | ReadoutInstrument); }
+void HudWidget::setAltitudeFt(double ft)   { m_altitudeFt = ft; m_visualValid = false; markDirty(AltitudeInstrument); }
+void HudWidget::setVSpeedFpm(double fpm)   { m_vspeedFpm = fpm; m_visualValid = false; markDirty(AltitudeInstrument); }
+
+HudWidget::Visual HudWidget::visual(double headingDeg, double rollDeg, double pitchDeg,
+                                    double altitudeFt, double vspeedFpm) const
+{
+    // Keys match what the draw functions compute from the same values
+    Visual v;
+    v.headingPx     = m_headingStrip.offsetPx(headingDeg);
+    v.headingTenths = qRound64(headingDeg * 10.0);
+    v.rollStep      = m_attitudeRenderer.rollStep(rollDeg);
+    v.pitchPx       = m_attitudeRenderer.pitchOffsetPx(pitchDeg);
+    v.rollTenths    = qRound64(rollDeg * 10.0);
+    v.pitchTenths   = qRound64(pitchDeg * 10.0);
+    v.altPx         = m_altitudeStrip.offsetPx(altitudeFt);
+    v.altFt         = qRound64(altitudeFt);
+    v.vspeedFpm     = qRound64(vspeedFpm);
+    return v;
+}
+
+void HudWidget::setSample(const HudSample &s)
+{
+    m_headingDeg = wrap360(s.headingDeg);
+    m_rollDeg    = s.rollDeg;
+    m_pitchDeg   = s.pitchDeg;
+    m_altitudeFt = s.altitudeFt;
+    m_vspeedFpm  = s.vspeedFpm;
+    m_sampleTsUs = s.tsUs;
+    m_sampleHostUs = s.hostUs;
+
+    // Geometry not known yet (or just changed): everything repaints anyway
+    if (m_sizedDirty) {
+        m_visualValid = false;
+        markDirty(AllInstruments);
+        return;
+    }
+
+    // With prediction on, paint shows the extrapolated attitude; judge
+    // the change on that (peek: only displayed frames go into the stats)
+    double heading = m_headingDeg, roll = m_rollDeg, pitch = m_pitchDeg;
+    if (m_predictor && m_predictor->hasSample()) {
+        const AttitudePredictor::Attitude a = m_predictor->peek(AttitudePredictor::steadyNowUs());
+        heading = wrap360(a.headingDeg);
+        roll    = a.rollDeg;
+        pitch   = a.pitchDeg;
+    }
+
+    const Visual v = visual(heading, roll, pitch, m_altitudeFt, m_vspeedFpm);
+    int dirty = AllInstruments;
+    if (m_visualValid) {
+        dirty = 0;
+        if (v.headingPx != m_visual.headingPx || v.headingTenths != m_visual.headingTenths)
+            dirty |= HeadingInstrument;
+        if (v.rollStep != m_visual.rollStep || v.pitchPx != m_visual.pitchPx)
+            dirty |= AttitudeInstrument;
+        if (v.rollTenths != m_visual.rollTenths || v.pitchTenths != m_visual.pitchTenths)
+            dirty |= ReadoutInstrument;
+        if (v.altPx != m_visual.altPx || v.altFt != m_visual.altFt || v.vspeedFpm != m_visual.vspeedFpm)
+            dirty |= AltitudeInstrument;
+    }
+    m_visual = v;
+    m_visualValid = true;
+
+    if (!dirty) ++m_samplesSkipped;
+    markDirty(dirty);
+}
+
+QRect HudWidget::instrumentRect(Instrument i, const Layout &l) const
+{
+    // Where per-frame content lands (static parts come from the layer),
+    // padded for antialiasing
+    QRectF r;
+    switch (i) {
+    case HeadingInstrument:  r = l.heading; break;
+    case AttitudeInstrument: r = l.attitude.adjusted(-3, -3, 3, 3); break;
+    case AltitudeInstrument: r = l.altitude.adjusted(0, 0, 0, l.altitude.height()*0.40); break;
+    case ReadoutInstrument:  r = l.bottom; break;
+    default: return rect();
+    }
+    return r.adjusted(-2, -2, 2, 2).toAlignedRect();
 }
 
-void HudWidget::setHeadingDeg(double deg)  { m_headingDeg = wrap360(deg); update(); }
-void HudWidget::setRollDeg(double deg)     { m_rollDeg = deg; update(); }
-void HudWidget::setPitchDeg(double deg)    { m_pitchDeg = deg; update(); }
-void HudWidget::setAltitudeFt(double ft)   { m_altitudeFt = ft; update(); }
-void HudWidget::setVSpeedFpm(double fpm)   { m_vspeedFpm = fpm; update(); }
+void HudWidget::markDirty(int instruments)
+{
+    if (!instruments) return;
+    QRegion region;
+    if (instruments == AllInstruments) {
+        region = rect();
+    } else {
+        const Layout l = layout();
+        for (Instrument i : { HeadingInstrument, AttitudeInstrument, AltitudeInstrument, ReadoutInstrument })
+            if (instruments & i) region += instrumentRect(i, l);
+    }
+
+    m_layersDirty |= instruments;
+    markDirtyRegion(region);
+}
+
+void HudWidget::markDirtyRegion(QRegion region)
+{
+    if (m_warp) {
+        // Repaint the source; the screen changes where the warp reads it
+        m_warpSrcDirty += region;
+        region = m_remap.isValid() ? warpFootprint(region, nullptr) : QRegion(rect());
+    }
+    if (m_externalPacing) m_pendingRegion += region;
+    else update(region);
+}
+
+void HudWidget::setAntialiasing(bool on)
+{
+    if (on == m_antialias) return;
+    m_antialias = on;
+    m_staticDirty = true;
+    m_layersDirty = AllInstruments;
+    update();
+}
+
+void HudWidget::setQualityLevel(int level)
+{
+    level = qBound(0, level, QualityGovernor::kLevels - 1);
+    if (level == m_quality) return;
+    m_quality = level;
+
+    // Resolution changes rebuild the DPR-keyed caches on the next paint
+    m_renderScale = level >= 3 ? 0.5 : level >= 2 ? 0.75 : 1.0;
+    if (!needsFrame()) m_frame = QImage();
+    m_attitudeRenderer.setSmoothTransform(level < 1);
+    m_layersDirty = AllInstruments;
+    m_visualValid = false;
+    markDirty(AllInstruments);
+}
+
+void HudWidget::setParallelRaster(bool on, int threads)
+{
+    if (threads <= 0) threads = qBound(1, QThread::idealThreadCount() - 1, 3);
+    m_pool.setMaxThreadCount(threads);
+    m_parallel = on;
+    m_layersDirty = AllInstruments;
+    update();
+}
 
-void HudWidget::paintEvent(QPaintEvent *)
+// Runs draw(), adding its wall time to *acc when acc is set
+template <typename Draw>
+static void timedDraw(double *acc, Draw &&draw)
 {
-    QPainter p(this);
+    if (!acc) {
+        draw();
+        return;
+    }
+    QElapsedTimer t;
+    t.start();
+    draw();
+    *acc += t.nsecsElapsed() / 1000.0;
+}
+
+namespace {
+
+class LayerTask : public QRunnable
+{
+public:
+    explicit LayerTask(std::function<void()> fn) : m_fn(std::move(fn)) {}
+    void run() override { m_fn(); }
+
+private:
+    std::function<void()> m_fn;
+};
+
+} // namespace
+
+void HudWidget::renderLayer(int index, const Layout &l)
+{
+    InstrumentLayer &layer = m_layers[index];
+    layer.image.fill(Qt::transparent);
+
+    QPainter p(&layer.image);
+    p.setRenderHint(QPainter::Antialiasing, frameAntialias());
+    p.setRenderHint(QPainter::TextAntialiasing, frameAntialias());
+    p.translate(-layer.rect.topLeft());
+
+    auto acc = [this](double &us) { return sectionTiming() ? &us : nullptr; };
+    switch (index) {
+    case 0: timedDraw(acc(m_sectionTimes.headingUs), [&] { drawHeadingTape(p, l.heading); }); break;
+    case 1: timedDraw(acc(m_sectionTimes.attitudeUs), [&] { drawAttitude(p, l.attitude); }); break;
+    case 2: timedDraw(acc(m_sectionTimes.altitudeUs), [&] { drawAltitudeTape(p, l.altitude); }); break;
+    case 3: timedDraw(acc(m_sectionTimes.readoutsUs), [&] { drawBottomReadouts(p, l.bottom); }); break;
+    }
+}
+
+void HudWidget::rasterizeLayers(const Layout &l, int wanted)
+{
+    // (Re)allocate on geometry / DPR change
+    const qreal dpr = renderDpr();
+    for (int i = 0; i < 4; ++i) {
+        InstrumentLayer &layer = m_layers[i];
+        const QRect rect = instrumentRect(Instrument(1 << i), l);
+        const QSize px = (QSizeF(rect.size()) * dpr).toSize();
+        if (layer.rect != rect || layer.image.size() != px || layer.image.devicePixelRatio() != dpr) {
+            layer.rect = rect;
+            layer.image = QImage(px, QImage::Format_ARGB32_Premultiplied);
+            layer.image.setDevicePixelRatio(dpr);
+            m_layersDirty |= 1 << i;
+        }
+    }
+
+    // Predicted attitude is taken at paint time, so it is never "unchanged"
+    int stale = m_layersDirty;
+    if (m_predictor && m_predictor->hasSample())
+        stale |= HeadingInstrument | AttitudeInstrument | ReadoutInstrument;
+    const int todo = stale & wanted;
+    if (!todo) return;
+
+    // Every draw function owns its caches (strip, sprite, text cache), so
+    // instruments can rasterize concurrently. The GUI thread takes the
+    // attitude ball, the most expensive one, and waits for the rest.
+    QSemaphore done;
+    int launched = 0, local = -1;
+    for (int i : { 1, 0, 2, 3 }) {
+        if (!(todo & (1 << i))) continue;
+        if (local < 0) {
+            local = i;
+            continue;
+        }
+        m_pool.start(new LayerTask([this, i, &l, &done] {
+            renderLayer(i, l);
+            done.release();
+        }));
+        ++launched;
+    }
+    renderLayer(local, l);
+    done.acquire(launched);
+
+    m_layersDirty &= ~todo;
+}
+
+void HudWidget::setWarp(const WarpMesh &mesh)
+{
+    m_warp = mesh.isValid();
+    m_warpMesh = mesh;
+    m_remap.clear();
+    m_warpOut = QImage();
+    m_warpSrcDirty = QRegion();
+    if (!needsFrame()) m_frame = QImage();
+    update();
+}
+
+void HudWidget::setRecorder(FrameRecorder *recorder)
+{
+    m_recorder = recorder;
+    m_captureDirty = rect();
+    if (!needsFrame()) m_frame = QImage();
+    update();
+}
+
+void HudWidget::setOutput(FramebufferOutput *output)
+{
+    m_output = output && output->isOpen() ? output : nullptr;
+    m_outImage = QImage();
+    if (m_output) {
+        resize(m_output->width(), m_output->height());
+        markDirtyRegion(rect());
+    } else if (!needsFrame()) {
+        m_frame = QImage();
+    }
+}
+
+void HudWidget::addMirror(HudMirror *mirror)
+{
+    if (!mirror || std::find(m_mirrors.begin(), m_mirrors.end(), mirror) != m_mirrors.end()) return;
+    m_mirrors.push_back(mirror);
+    // The whole frame once, so the mirror starts complete
+    markDirtyRegion(rect());
+}
+
+// Copies what was repainted (warp output, else the offscreen frame, scaled
+// up when rendering below full resolution) to the output and flips it
+void HudWidget::presentFrame(const QRegion &painted)
+{
+    const QImage *img = m_warp ? &m_warpOut : &m_frame;
+    if (img->isNull()) return;
+
+    QRegion rects = painted;
+    if (!m_warp && m_frame.devicePixelRatio() != 1.0) {
+        if (m_outImage.size() != size()) {
+            m_outImage = QImage(size(), QImage::Format_RGB32);
+            rects = rect();
+        }
+        QPainter sp(&m_outImage);
+        sp.setRenderHint(QPainter::SmoothPixmapTransform, true);
+        const qreal s = m_frame.devicePixelRatio();
+        for (const QRect &rc : rects)
+            sp.drawImage(QRectF(rc), m_frame, QRectF(rc.x() * s, rc.y() * s, rc.width() * s, rc.height() * s));
+        img = &m_outImage;
+    }
+
+    const qreal s = img->devicePixelRatio();
+    m_outRects.clear();
+    for (const QRect &rc : rects) {
+        const QRect r = QRectF(rc.x() * s, rc.y() * s, rc.width() * s, rc.height() * s).toAlignedRect();
+        m_outRects.push_back(FramebufferOutput::Rect{ r.x(), r.y(), r.width(), r.height() });
+    }
+    m_output->present(reinterpret_cast<const uint32_t *>(img->constBits()), img->bytesPerLine() / 4,
+                      m_outRects.data(), int(m_outRects.size()));
+}
+
+// Queues the frame as shown (warp output, else the offscreen frame) with
+// every rect that changed since the recorder last took one
+void HudWidget::captureFrame(const QRegion &painted)
+{
+    const QImage &img = m_warp ? m_warpOut : m_frame;
+    if (img.isNull()) return;
+    m_captureDirty += painted;
+
+    const qreal s = img.devicePixelRatio();
+    m_captureRects.clear();
+    for (const QRect &rc : m_captureDirty) {
+        const QRect r = QRectF(rc.x() * s, rc.y() * s, rc.width() * s, rc.height() * s).toAlignedRect();
+        m_captureRects.push_back(FrameRecorder::Rect{ r.x(), r.y(), r.width(), r.height() });
+    }
+
+    FrameRecorder::Meta meta;
+    meta.frameUs = AttitudePredictor::steadyNowUs();
+    meta.sampleTsUs = m_sampleTsUs;
+    meta.sampleHostUs = m_sampleHostUs;
+    if (m_recorder->submit(reinterpret_cast<const uint32_t *>(img.constBits()), img.bytesPerLine() / 4,
+                           img.width(), img.height(), m_captureRects.data(), int(m_captureRects.size()), meta))
+        m_captureDirty = QRegion();
+}
+
+// Rebuilds the remap when the frame or widget size changed; true if it did
+bool HudWidget::updateRemap()
+{
+    const qreal dpr = devicePixelRatioF();
+    const QSize out = (QSizeF(size()) * dpr).toSize();
+    if (m_remap.isValid() && m_remap.outWidth() == out.width() && m_remap.outHeight() == out.height() &&
+        m_remap.srcWidth() == m_frame.width() && m_remap.srcHeight() == m_frame.height())
+        return false;
+
+    m_remap.build(m_warpMesh, out.width(), out.height(), m_frame.width(), m_frame.height());
+    m_warpOut = QImage(out, QImage::Format_RGB32);
+    m_warpOut.setDevicePixelRatio(dpr);
+    m_warpOut.fill(Qt::black);   // tiles that only sample outside are never warped
+    return true;
+}
+
+// Output tiles that read any pixel of a source region (logical coordinates):
+// marks them in *mask and returns their bounding rect per source rect
+QRegion HudWidget::warpFootprint(const QRegion &source, std::vector<uint8_t> *mask) const
+{
+    const int tilesX = m_remap.tilesX(), tilesY = m_remap.tilesY();
+    if (mask) mask->assign(size_t(tilesX) * tilesY, 0);
+
+    const qreal s = m_frame.devicePixelRatio();
+    const qreal o = m_warpOut.devicePixelRatio();
+    QRegion out;
+    for (const QRect &rc : source) {
+        const QRect sr = QRectF(rc.x() * s, rc.y() * s, rc.width() * s, rc.height() * s).toAlignedRect();
+        const WarpRemap::Rect f = m_remap.footprint(WarpRemap::Rect{ sr.left(), sr.top(), sr.right() + 1, sr.bottom() + 1 },
+                                                    mask ? mask->data() : nullptr);
+        if (f.x1 > f.x0)
+            out += QRectF(f.x0 / o, f.y0 / o, (f.x1 - f.x0) / o, (f.y1 - f.y0) / o).toAlignedRect();
+    }
+    return out;
+}
+
+// Re-warps the tiles that read the repainted source, in bands of tile rows
+// on the pool; the GUI thread takes the first band
+void HudWidget::warpFrame(const QRegion &source)
+{
+    if (!m_remap.isValid() || source.isEmpty()) return;
+    warpFootprint(source, &m_warpMask);
+
+    const int tilesX = m_remap.tilesX();
+    int first = -1, last = -1;
+    for (int ty = 0; ty < m_remap.tilesY(); ++ty) {
+        const uint8_t *row = m_warpMask.data() + size_t(ty) * tilesX;
+        if (std::find(row, row + tilesX, 1) == row + tilesX) continue;
+        if (first < 0) first = ty;
+        last = ty;
+    }
+    if (first < 0) return;
+
+    const uint32_t *src = reinterpret_cast<const uint32_t *>(m_frame.constBits());
+    uint32_t *dst = reinterpret_cast<uint32_t *>(m_warpOut.bits());
+    const int srcStride = m_frame.bytesPerLine() / 4, dstStride = m_warpOut.bytesPerLine() / 4;
+    const int rows = last - first + 1;
+    const int bands = qMin(rows, m_pool.maxThreadCount() + 1);
+    auto band = [&](int b) {
+        m_remap.apply(src, srcStride, dst, dstStride,
+                      first + rows * b / bands, first + rows * (b + 1) / bands, m_warpMask.data());
+    };
+
+    QSemaphore done;
+    for (int b = 1; b < bands; ++b) {
+        m_pool.start(new LayerTask([&band, b, &done] {
+            band(b);
+            done.release();
+        }));
+    }
+    band(0);
+    done.acquire(bands - 1);
+}
+
+void HudWidget::setExternalPacing(bool on)
+{
+    m_externalPacing = on;
+    if (!on && !m_pendingRegion.isEmpty()) {
+        update(m_pendingRegion);
+        m_pendingRegion = QRegion();
+    }
+}
+
+bool HudWidget::renderPending()
+{
+    if (m_pendingRegion.isEmpty()) return false;
+    const QRegion region = m_pendingRegion;
+    m_pendingRegion = QRegion();
+    if (m_output) {
+        // No window: paint offscreen and present from there
+        QPaintEvent ev(region);
+        paintEvent(&ev);
+    } else {
+        repaint(region);
+    }
+    return true;
+}
+
+void HudWidget::setStaticLayerEnabled(bool on)
+{
+    m_staticEnabled = on;
+    m_staticDirty = true;
+    if (!on) {
+        m_staticLayer = QPixmap();
+        m_attitudeOverlay = QPixmap();
+    }
+    update();
+}
+
+HudWidget::PaintStats HudWidget::takePaintStats()
+{
+    PaintStats st;
+    st.frames = m_paintFrames;
+    st.skipped = m_samplesSkipped;
+    st.quality = m_quality;
+    st.meanUs = m_paintFrames ? m_paintSumUs / m_paintFrames : 0.0;
+    st.maxUs  = m_paintMaxUs;
+    m_paintFrames = 0;
+    m_samplesSkipped = 0;
+    m_paintSumUs = m_paintMaxUs = 0.0;
+    return st;
+}
+
+void HudWidget::resizeEvent(QResizeEvent *event)
+{
+    m_staticDirty = true;
+    m_sizedDirty = true;
+    QWidget::resizeEvent(event);
+}
+
+void HudWidget::keyPressEvent(QKeyEvent *event)
+{
+    if (event->key() == Qt::Key_F3) setPerfOverlay(!m_perfOn);
+    else QWidget::keyPressEvent(event);
+}
+
+void HudWidget::setPerfOverlay(bool on)
+{
+    if (on == m_perfOn) return;
+    m_perfOn = on;
+    m_perfImage = QImage();
+    if (on) {
+        m_perfClock.start();
+        m_perfLastFrameNs = -1;
+        m_perfLastBuildNs = 0;
+        m_perfHead = m_perfFilled = 0;
+        rebuildPerfOverlay();
+    }
+    markDirtyRegion(perfRect());
+}
+
+// Top left, clear of the heading tape
+QRect HudWidget::perfRect() const
+{
+    return QRectF(width() * 0.01, height() * 0.02, width() * 0.27, height() * 0.20).toAlignedRect();
+}
+
+// Per painted frame: a few adds. The panel itself is redrawn at 2 Hz,
+// outside the measured paint time.
+void HudWidget::notePerfFrame(double paintUs)
+{
+    const qint64 now = m_perfClock.nsecsElapsed();
+    if (m_perfLastFrameNs >= 0) {
+        m_perfIntervalMs[m_perfHead] = float((now - m_perfLastFrameNs) / 1e6);
+        m_perfPaintMs[m_perfHead] = float(paintUs / 1000.0);
+        m_perfHead = (m_perfHead + 1) % kPerfHistory;
+        m_perfFilled = qMin(m_perfFilled + 1, kPerfHistory);
+    }
+    m_perfLastFrameNs = now;
+
+    ++m_perfFrames;
+    m_perfPaintSumUs += paintUs;
+    m_perfPaintMaxUs = qMax(m_perfPaintMaxUs, paintUs);
+    m_perfSections.headingUs  += m_sectionTimes.headingUs;
+    m_perfSections.attitudeUs += m_sectionTimes.attitudeUs;
+    m_perfSections.altitudeUs += m_sectionTimes.altitudeUs;
+    m_perfSections.readoutsUs += m_sectionTimes.readoutsUs;
+    m_perfSections.iconsUs    += m_sectionTimes.iconsUs;
+    m_perfSections.warpUs     += m_sectionTimes.warpUs;
+    if (m_sampleHostUs > 0) {
+        const double age = double(AttitudePredictor::steadyNowUs() - m_sampleHostUs);
+        m_perfAgeSumUs += age;
+        m_perfAgeMaxUs = qMax(m_perfAgeMaxUs, age);
+        ++m_perfAgeCount;
+    }
+
+    if (now - m_perfLastBuildNs >= 500000000LL) {
+        rebuildPerfOverlay();
+        markDirtyRegion(m_perfRect);
+    }
+}
+
+void HudWidget::rebuildPerfOverlay()
+{
+    const qint64 now = m_perfClock.nsecsElapsed();
+    const double secs = qMax(1e-3, (now - m_perfLastBuildNs) / 1e9);
+    m_perfLastBuildNs = now;
+
+    m_perfRect = perfRect();
+    if (m_perfRect.isEmpty()) return;
+    const qreal dpr = renderDpr();
+    const QSize px = (QSizeF(m_perfRect.size()) * dpr).toSize();
+    if (m_perfImage.size() != px || m_perfImage.devicePixelRatio() != dpr) {
+        m_perfImage = QImage(px, QImage::Format_ARGB32_Premultiplied);
+        m_perfImage.setDevicePixelRatio(dpr);
+    }
+    m_perfImage.fill(QColor(0, 0, 0, 180));
+
+    QPainter p(&m_perfImage);
     p.setRenderHint(QPainter::Antialiasing, true);
     p.setRenderHint(QPainter::TextAntialiasing, true);
+    QFont f = font();
+    f.setFamily(QStringLiteral("monospace"));
+    f.setStyleHint(QFont::Monospace);
+    f.setPixelSize(qMax(8, int(m_perfRect.height() / 8.5)));
+    p.setFont(f);
+    const int lh = QFontMetrics(f).height();
+    const QRectF area(4, 2, m_perfRect.width() - 8, m_perfRect.height() - 4);
+    const QColor text(230, 230, 230);
+    auto line = [&](int row, const QString &s) {
+        p.setPen(text);
+        p.drawText(QPointF(area.left(), area.top() + lh * row + QFontMetrics(f).ascent()), s);
+    };
+
+    const double frames = qMax(1, m_perfFrames);
+    line(0, QString("FPS %1  paint %2 / %3 ms")
+                .arg(m_perfFrames / secs, 0, 'f', 1)
+                .arg(m_perfPaintSumUs / frames / 1000.0, 0, 'f', 2)
+                .arg(m_perfPaintMaxUs / 1000.0, 0, 'f', 2));
+
+    // Sparkline: frame interval (bright) and paint time (amber), oldest
+    // left, against the 60 Hz period
+    const QRectF spark(area.left(), area.top() + lh * 1.15, area.width(), lh * 2.7);
+    float top = 20.0f;
+    for (int i = 0; i < m_perfFilled; ++i) top = qMax(top, m_perfIntervalMs[i]);
+    auto y = [&](float ms) { return spark.bottom() - spark.height() * qMin(1.0f, ms / top); };
+    p.setPen(QPen(QColor(255, 255, 255, 60), 1.0, Qt::DashLine));
+    p.drawLine(QPointF(spark.left(), y(16.7f)), QPointF(spark.right(), y(16.7f)));
+    for (int series = 0; series < 2; ++series) {
+        const float *v = series ? m_perfPaintMs : m_perfIntervalMs;
+        QPolygonF poly;
+        for (int i = 0; i < m_perfFilled; ++i) {
+            const int k = (m_perfHead - m_perfFilled + i + kPerfHistory) % kPerfHistory;
+            poly << QPointF(spark.left() + spark.width() * i / (kPerfHistory - 1), y(v[k]));
+        }
+        p.setPen(QPen(series ? QColor(255, 190, 60) : QColor(120, 255, 140), 1.0));
+        p.drawPolyline(poly);
+    }
+
+    const SectionTimes &st = m_perfSections;
+    line(4, QString("hdg %1 att %2 alt %3 rdo %4 warp %5")
+                .arg(st.headingUs / frames / 1000.0, 0, 'f', 2)
+                .arg(st.attitudeUs / frames / 1000.0, 0, 'f', 2)
+                .arg(st.altitudeUs / frames / 1000.0, 0, 'f', 2)
+                .arg(st.readoutsUs / frames / 1000.0, 0, 'f', 2)
+                .arg(st.warpUs / frames / 1000.0, 0, 'f', 2));
+    line(5, QString("link %1/s  crc %2%  len %3%  queue %4")
+                .arg(m_perfIn.samplesPerSec, 0, 'f', 0)
+                .arg(m_perfIn.crcErrorPct, 0, 'f', 2).arg(m_perfIn.lenErrorPct, 0, 'f', 2)
+                .arg(m_perfIn.queueDepth < 0 ? QStringLiteral("-") : QString::number(m_perfIn.queueDepth)));
+    line(6, m_perfAgeCount ? QString("sample age %1 ms (max %2)")
+                                 .arg(m_perfAgeSumUs / m_perfAgeCount / 1000.0, 0, 'f', 1)
+                                 .arg(m_perfAgeMaxUs / 1000.0, 0, 'f', 1)
+                           : QStringLiteral("sample age -"));
+
+    m_perfFrames = 0;
+    m_perfPaintSumUs = m_perfPaintMaxUs = m_perfAgeSumUs = m_perfAgeMaxUs = 0.0;
+    m_perfAgeCount = 0;
+    m_perfSections = SectionTimes();
+}
+
+void HudWidget::changeEvent(QEvent *event)
+{
+    switch (event->type()) {
+    case QEvent::PaletteChange:
+    case QEvent::StyleChange:
+    case QEvent::FontChange:
+    case QEvent::ApplicationFontChange:
+        m_staticDirty = true;
+        m_sizedDirty = true;
+        update();
+        break;
+    default:
+        break;
+    }
+    QWidget::changeEvent(event);
+}
 
-    // Background
-    p.fillRect(rect(), Qt::black);
+HudWidget::Layout HudWidget::layout() const
+{
+    const double W = width();
+    const double H = height();
+
+    Layout l;
+    l.heading  = QRectF(W*0.30, H*0.05, W*0.40, H*0.10);
+    l.attitude = QRectF(W*0.37, H*0.24, W*0.26, H*0.42);
+    l.altitude = QRectF(W*0.67, H*0.24, W*0.10, H*0.42);
+    l.bottom   = QRectF(W*0.35, H*0.75, W*0.30, H*0.10);
+    // little buttons in bottom-right (optional)
+    l.icons    = QRectF(W*0.90, H*0.84, W*0.08, H*0.10);
+    return l;
+}
+
+void HudWidget::rebuildStaticLayer()
+{
+    const qreal dpr = renderDpr();
+    const Layout l = layout();
+
+    m_staticLayer = QPixmap(size() * dpr);
+    m_staticLayer.setDevicePixelRatio(dpr);
+    m_staticLayer.fill(Qt::black);
+    {
+        QPainter p(&m_staticLayer);
+        p.setRenderHint(QPainter::Antialiasing, m_antialias);
+        p.setRenderHint(QPainter::TextAntialiasing, m_antialias);
+        p.setFont(font());
+        drawStatic(p, l);
+    }
 
-    // Layout (relative to window size)
-    const QRectF full = rect();
-    const double W = full.width();
-    const double H = full.height();
+    // Pen half-width + a pixel of AA fringe around the circle
+    m_attitudeOverlayRect = l.attitude.adjusted(-3, -3, 3, 3).toAlignedRect();
+    m_attitudeOverlay = QPixmap((m_attitudeOverlayRect.size() * dpr).toSize());
+    m_attitudeOverlay.setDevicePixelRatio(dpr);
+    m_attitudeOverlay.fill(Qt::transparent);
+    {
+        QPainter p(&m_attitudeOverlay);
+        p.setRenderHint(QPainter::Antialiasing, m_antialias);
+        p.translate(-m_attitudeOverlayRect.topLeft());
+        drawAttitudeOverlay(p, l.attitude);
+    }
 
-    QRectF headingRect(W*0.30, H*0.05, W*0.40, H*0.10);
-    QRectF attitudeRect(W*0.37, H*0.24, W*0.26, H*0.42);
-    QRectF altitudeRect(W*0.67, H*0.24, W*0.10, H*0.42);
-    QRectF bottomRect(W*0.35, H*0.75, W*0.30, H*0.10);
+    m_staticDirty = false;
+}
 
-    drawHeadingTape(p, headingRect);
-    drawAttitude(p, attitudeRect);
-    drawAltitudeTape(p, altitudeRect);
-    drawBottomReadouts(p, bottomRect);
+// Tape scale regions (inside the outer boxes)
+static QRectF headingInnerRect(const QRectF &r)
+{
+    return r.adjusted(10, 10, -10, -10);
+}
 
-    // little buttons in bottom-right (optional)
-    QRectF iconArea(W*0.90, H*0.84, W*0.08, H*0.10);
-    drawIconButtons(p, iconArea);
+static QRectF altitudeInnerRect(const QRectF &r)
+{
+    return r.adjusted(r.width()*0.12, r.height()*0.08, -r.width()*0.12, -r.height()*0.08);
 }
 
-static QPen hudPen(double w = 2.0)
+void HudWidget::rebuildSizedCaches(const Layout &l)
 {
-    QPen pen(QColor(230, 230, 230));
-    pen.setWidthF(w);
-    pen.setCapStyle(Qt::RoundCap);
-    pen.setJoinStyle(Qt::RoundJoin);
-    return pen;
+    auto sized = [this](double pt) {
+        QFont f = font();
+        f.setPointSizeF(pt);
+        return f;
+    };
+    m_txtHeadingReadout.setFont(sized(l.heading.height()*0.22));
+    m_txtAltReadout.setFont(sized(l.altitude.height()*0.12));
+    m_txtVspeed.setFont(sized(l.altitude.height()*0.07));
+    m_txtAttitudeReadout.setFont(sized(l.bottom.height()*0.26));
+
+    m_sizedDpr = renderDpr();
+    m_headingStrip.configure(headingInnerRect(l.heading).size(), m_sizedDpr,
+                             sized(l.heading.height()*0.18));
+    m_altitudeStrip.configure(altitudeInnerRect(l.altitude).size(), m_sizedDpr,
+                              sized(l.altitude.height()*0.07));
+    m_attitudeRenderer.configure(l.attitude.size(), m_sizedDpr,
+                                 sized(l.attitude.height()*0.06));
+    m_visualValid = false;
+    m_layersDirty = AllInstruments;
+    m_sizedDirty = false;
 }
 
-void HudWidget::drawHeadingTape(QPainter &p, const QRectF &r)
+// Tenths-of-a-degree readout with a degree sign, e.g. "-2.8°"
+static const QStaticText& degreeText(HudTextCache &cache, double deg)
+{
+    const qint64 key = qRound64(deg * 10.0);
+    if (const QStaticText* t = cache.find(key)) return *t;
+    char buf[32];
+    int n = formatFixed(buf, key / 10.0, 1);
+    buf[n++] = '\xB0';   // Latin-1 degree sign
+    return cache.insert(key, buf, n);
+}
+
+static const QStaticText& intText(HudTextCache &cache, qint64 v, const char* suffix = nullptr)
+{
+    if (const QStaticText* t = cache.find(v)) return *t;
+    char buf[48];
+    int n = formatInt(buf, v);
+    while (suffix && *suffix) buf[n++] = *suffix++;
+    return cache.insert(v, buf, n);
+}
+
+void HudWidget::paintEvent(QPaintEvent *event)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    if (m_predictor && m_predictor->hasSample()) {
+        const AttitudePredictor::Attitude a = m_predictor->predict(AttitudePredictor::steadyNowUs());
+        m_rollDeg    = a.rollDeg;
+        m_pitchDeg   = a.pitchDeg;
+        m_headingDeg = wrap360(a.headingDeg);
+    }
+
+    const Layout l = layout();
+    if (m_staticEnabled &&
+        (m_staticDirty || m_staticLayer.devicePixelRatioF() != renderDpr()))
+        rebuildStaticLayer();
+    if (m_sizedDirty || m_sizedDpr != renderDpr())
+        rebuildSizedCaches(l);
+
+    m_sectionTimes = SectionTimes();
+    auto acc = [this](double &us) { return sectionTiming() ? &us : nullptr; };
+
+    // Below full resolution, when warping or recording, paint into an image
+    // with the same logical coordinates and scale / warp / copy the dirty
+    // rects afterwards
+    QRegion region = event->region();
+    QPaintDevice *target = this;
+    if (needsFrame()) {
+        const qreal dpr = renderDpr();
+        const QSize px = (QSizeF(size()) * dpr).toSize();
+        bool fresh = false;
+        if (m_frame.size() != px || m_frame.devicePixelRatio() != dpr) {
+            m_frame = QImage(px, QImage::Format_RGB32);
+            m_frame.setDevicePixelRatio(dpr);
+            fresh = true;
+        }
+        target = &m_frame;
+        if (fresh && !m_warp) region = rect();
+
+        // What to repaint is the source marked dirty, not the screen region;
+        // a full-window paint (expose, resize, settings) redoes everything
+        if (m_warp) {
+            if (updateRemap() || fresh || region == QRegion(rect())) m_warpSrcDirty = rect();
+            region = m_warpSrcDirty;
+            m_warpSrcDirty = QRegion();
+        }
+    }
+
+    QPainter p(target);
+    if (target != this) p.setClipRegion(region);
+    p.setRenderHint(QPainter::Antialiasing, frameAntialias());
+    p.setRenderHint(QPainter::TextAntialiasing, frameAntialias());
+
+    // Only what Qt asked for; the painter is clipped to it
+    auto needs = [&](Instrument i) { return region.intersects(instrumentRect(i, l)); };
+
+    // Background + everything that doesn't move
+    if (m_staticEnabled) {
+        const qreal dpr = m_staticLayer.devicePixelRatioF();
+        for (const QRect &rc : region)
+            p.drawPixmap(rc, m_staticLayer,
+                         QRectF(rc.x() * dpr, rc.y() * dpr, rc.width() * dpr, rc.height() * dpr));
+    } else {
+        for (const QRect &rc : region)
+            p.fillRect(rc, Qt::black);
+        drawStatic(p, l);
+    }
+
+    if (m_parallel && m_staticEnabled) {
+        // Re-render what changed, then blit every requested layer
+        int wanted = 0;
+        for (Instrument i : { HeadingInstrument, AttitudeInstrument, AltitudeInstrument, ReadoutInstrument })
+            if (needs(i)) wanted |= i;
+        rasterizeLayers(l, wanted);
+        for (int i = 0; i < 4; ++i)
+            if (wanted & (1 << i))
+                p.drawImage(m_layers[i].rect.topLeft(), m_layers[i].image);
+    } else {
+        if (needs(HeadingInstrument))
+            timedDraw(acc(m_sectionTimes.headingUs), [&] { drawHeadingTape(p, l.heading); });
+        if (needs(AttitudeInstrument))
+            timedDraw(acc(m_sectionTimes.attitudeUs), [&] { drawAttitude(p, l.attitude); });
+        if (needs(AltitudeInstrument))
+            timedDraw(acc(m_sectionTimes.altitudeUs), [&] { drawAltitudeTape(p, l.altitude); });
+        if (needs(ReadoutInstrument))
+            timedDraw(acc(m_sectionTimes.readoutsUs), [&] { drawBottomReadouts(p, l.bottom); });
+    }
+
+    // Fixed marker sits on top of the moving horizon
+    if (needs(AttitudeInstrument)) {
+        timedDraw(acc(m_sectionTimes.attitudeUs), [&] {
+            if (m_staticEnabled)
+                p.drawPixmap(m_attitudeOverlayRect.topLeft(), m_attitudeOverlay);
+            else
+                drawAttitudeOverlay(p, l.attitude);
+        });
+    }
+
+    if (m_perfOn) {
+        if (m_perfRect != perfRect()) rebuildPerfOverlay();
+        if (region.intersects(m_perfRect)) p.drawImage(m_perfRect.topLeft(), m_perfImage);
+    }
+
+    p.end();
+
+    if (m_warp) {
+        // The warp resamples from m_frame, so it also does the upscale
+        timedDraw(acc(m_sectionTimes.warpUs), [&] { warpFrame(region); });
+        if (!m_output) {
+            QPainter wp(this);
+            const qreal o = m_warpOut.devicePixelRatio();
+            for (const QRect &rc : event->region())
+                wp.drawImage(QRectF(rc), m_warpOut, QRectF(rc.x() * o, rc.y() * o, rc.width() * o, rc.height() * o));
+        }
+    } else if (target != this && !m_output) {
+        QPainter wp(this);
+        wp.setRenderHint(QPainter::SmoothPixmapTransform, true);
+        const qreal s = m_frame.devicePixelRatio();
+        for (const QRect &rc : region)
+            wp.drawImage(QRectF(rc), m_frame, QRectF(rc.x() * s, rc.y() * s, rc.width() * s, rc.height() * s));
+    }
+
+    // Paint time ends here: handing the frame on (a present can wait for
+    // vsync) must not count against the quality governor. The output
+    // reports its own copy / wait times.
+    const double us = timer.nsecsElapsed() / 1000.0;
+
+    for (HudMirror *m : m_mirrors) m->sourceUpdated(m_frame, size(), region);
+    if (m_output) presentFrame(m_warp ? event->region() : region);
+    if (m_recorder) captureFrame(m_warp ? event->region() : region);
+
+    ++m_paintFrames;
+    m_paintSumUs += us;
+    if (us > m_paintMaxUs) m_paintMaxUs = us;
+
+    if (m_perfOn) notePerfFrame(us);
+    if (m_governor) setQualityLevel(m_governor->addFrame(us));
+}
+
+void HudWidget::drawStatic(QPainter &p, const Layout &l)
+{
+    drawHeadingFrame(p, l.heading);
+    drawAttitudeFrame(p, l.attitude);
+    drawAltitudeFrame(p, l.altitude);
+    drawBottomFrame(p, l.bottom);
+    timedDraw(sectionTiming() ? &m_sectionTimes.iconsUs : nullptr, [&] { drawIconButtons(p, l.icons); });
+}
+
+static QRectF headingReadoutRect(const QRectF &r)
+{
+    return QRectF(r.center().x() - r.width()*0.07, r.center().y() - r.height()*0.12,
+                  r.width()*0.14, r.height()*0.24);
+}
+
+void HudWidget::drawHeadingFrame(QPainter &p, const QRectF &r)
 {
     p.save();
     p.setPen(hudPen(2.0));
@@ -74,49 +921,8 @@ void HudWidget::drawHeadingTape(QPainter &p, const QRectF &r)
     const QPointF topMid(r.center().x(), r.top());
     p.drawLine(QPointF(topMid.x(), r.top()-10), QPointF(topMid.x(), r.top()+8));
 
-    // Tick line region (inside)
-    QRectF inner = r.adjusted(10, 10, -10, -10);
-    const double pxPerDeg = inner.width() / 60.0; // show ~60 degrees across
-
-    // Base heading shown at center
-    const double centerHdg = m_headingDeg;
-    const double startDeg = centerHdg - 30.0;
-
-    // ticks every 5 degrees, longer every 10
-    for (int i = 0; i <= 60; i += 5) {
-        double deg = startDeg + i;
-        double x = inner.left() + (deg - startDeg) * pxPerDeg;
-
-        double tickH = ( (int)qRound(deg) % 10 == 0 ) ? inner.height()*0.55 : inner.height()*0.35;
-        p.drawLine(QPointF(x, inner.bottom()), QPointF(x, inner.bottom() - tickH));
-
-        // labels for cardinal-ish around (simple)
-        if (((int)qRound(deg) % 30) == 0) {
-            QString label;
-            double d = wrap360(deg);
-            if (qFuzzyCompare(d, 0.0) || qFuzzyCompare(d, 360.0)) label = "N";
-            else if (qFuzzyCompare(d, 90.0)) label = "E";
-            else if (qFuzzyCompare(d, 180.0)) label = "S";
-            else if (qFuzzyCompare(d, 270.0)) label = "W";
-            else label = QString::number((int)qRound(d));
-
-            QFont f = p.font();
-            f.setPointSizeF(r.height()*0.18);
-            p.setFont(f);
-            p.drawText(QRectF(x-20, inner.top(), 40, inner.height()*0.6),
-                       Qt::AlignHCenter | Qt::AlignVCenter, label);
-        }
-    }
-
     // Center numeric readout box
-    QRectF readout(r.center().x() - r.width()*0.07, r.center().y() - r.height()*0.12,
-                   r.width()*0.14, r.height()*0.24);
-    p.drawRect(readout);
-
-    QFont f = p.font();
-    f.setPointSizeF(r.height()*0.22);
-    p.setFont(f);
-    p.drawText(readout, Qt::AlignCenter, QString::number(m_headingDeg, 'f', 1) + "°");
+    p.drawRect(headingReadoutRect(r));
 
     // "HEADING" label
     QFont f2 = p.font();
@@ -128,84 +934,27 @@ void HudWidget::drawHeadingTape(QPainter &p, const QRectF &r)
     p.restore();
 }
 
-void HudWidget::drawAttitude(QPainter &p, const QRectF &r)
+void HudWidget::drawHeadingTape(QPainter &p, const QRectF &r)
 {
     p.save();
     p.setPen(hudPen(2.0));
     p.setBrush(Qt::NoBrush);
 
-    // Circle bounds
-    QRectF circle = r;
-    p.drawEllipse(circle);
-
-    // Clip to circle so the horizon doesn't draw outside
-    QPainterPath clip;
-    clip.addEllipse(circle);
-    p.setClipPath(clip);
-
-    // Horizon / pitch ladder:
-    // Map pitch degrees to pixels; positive pitch means nose up => horizon moves down.
-    const double pxPerDeg = circle.height() / 30.0; // ~30° visible vertically
-    const double horizonY = circle.center().y() + (-m_pitchDeg * pxPerDeg);
+    // Scrolling scale: constant-cost blit from the pre-rendered strip
+    m_headingStrip.draw(p, headingInnerRect(r), m_headingDeg);
 
-    // Draw "sky" and "ground"
-    QRectF skyRect(circle.left(), circle.top(), circle.width(), horizonY - circle.top());
-    QRectF groundRect(circle.left(), horizonY, circle.width(), circle.bottom() - horizonY);
+    // Center numeric readout
+    p.setFont(m_txtHeadingReadout.font());
+    HudTextCache::draw(p, headingReadoutRect(r), Qt::AlignCenter,
+                       degreeText(m_txtHeadingReadout, m_headingDeg));
 
-    p.fillRect(skyRect, QColor(20, 80, 140));     // blue
-    p.fillRect(groundRect, QColor(45, 45, 45));   // dark gray
+    p.restore();
+}
 
-    // Roll rotation around center for ladder lines
+void HudWidget::drawAttitudeFrame(QPainter &p, const QRectF &r)
+{
     p.save();
-    p.translate(circle.center());
-    p.rotate(-m_rollDeg); // negative to match typical aircraft convention
-    p.translate(-circle.center());
-
-    // Horizon line
-    p.setPen(hudPen(3.0));
-    p.drawLine(QPointF(circle.left(), horizonY), QPointF(circle.right(), horizonY));
-
-    // Pitch ladder lines every 5 degrees (above and below horizon)
     p.setPen(hudPen(2.0));
-    QFont f = p.font();
-    f.setPointSizeF(circle.height()*0.06);
-    p.setFont(f);
-
-    for (int deg = -30; deg <= 30; deg += 5) {
-        if (deg == 0) continue;
-        double y = horizonY - (deg * pxPerDeg);
-        if (y < circle.top()-20 || y > circle.bottom()+20) continue;
-
-        double halfLen = (qAbs(deg) % 10 == 0) ? circle.width()*0.22 : circle.width()*0.16;
-        QPointF L(circle.center().x() - halfLen, y);
-        QPointF R(circle.center().x() + halfLen, y);
-
-        p.drawLine(L, R);
-
-        // Labels for 10-degree marks (like your screenshot)
-        if (qAbs(deg) % 10 == 0) {
-            QString t = QString::number(qAbs(deg));
-            QRectF leftText(L.x() - 30, y - 10, 28, 20);
-            QRectF rightText(R.x() + 2, y - 10, 28, 20);
-            p.drawText(leftText, Qt::AlignRight | Qt::AlignVCenter, t);
-            p.drawText(rightText, Qt::AlignLeft  | Qt::AlignVCenter, t);
-        }
-    }
-
-    p.restore(); // roll transform
-
-    // Unclip
-    p.setClipping(false);
-
-    // Center little reference marker (fixed, not rolling)
-    p.setPen(hudPen(2.5));
-    const QPointF c = circle.center();
-    p.drawLine(QPointF(c.x() - circle.width()*0.10, c.y()),
-               QPointF(c.x() - circle.width()*0.02, c.y()));
-    p.drawLine(QPointF(c.x() + circle.width()*0.02, c.y()),
-               QPointF(c.x() + circle.width()*0.10, c.y()));
-    p.drawLine(QPointF(c.x(), c.y() - circle.height()*0.02),
-               QPointF(c.x(), c.y() + circle.height()*0.02));
 
     // "ATTITUDE" label below
     QFont f3 = p.font();
@@ -217,7 +966,25 @@ void HudWidget::drawAttitude(QPainter &p, const QRectF &r)
     p.restore();
 }
 
-void HudWidget::drawAltitudeTape(QPainter &p, const QRectF &r)
+void HudWidget::drawAttitudeOverlay(QPainter &p, const QRectF &r)
+{
+    AttitudeRenderer::paintReference(p, r);
+}
+
+void HudWidget::drawAttitude(QPainter &p, const QRectF &r)
+{
+    // Sky/ground, horizon and ladder: one rotated sprite blit cut by the
+    // cached circle mask (no path clipping)
+    m_attitudeRenderer.draw(p, r, m_rollDeg, m_pitchDeg);
+}
+
+static QRectF altitudeReadoutRect(const QRectF &r)
+{
+    return QRectF(r.left() + r.width()*0.20, r.center().y() - r.height()*0.07,
+                  r.width()*0.60, r.height()*0.14);
+}
+
+void HudWidget::drawAltitudeFrame(QPainter &p, const QRectF &r)
 {
     p.save();
     p.setPen(hudPen(2.0));
@@ -226,69 +993,43 @@ void HudWidget::drawAltitudeTape(QPainter &p, const QRectF &r)
     // Outer rect
     p.drawRoundedRect(r, 2, 2);
 
-    // Inner scale region
-    QRectF inner = r.adjusted(r.width()*0.12, r.height()*0.08, -r.width()*0.12, -r.height()*0.08);
-
-    // Vertical mapping: show +- 500 ft around current altitude
-    const double spanFt = 1000.0;
-    const double pxPerFt = inner.height() / spanFt;
-
-    const double centerAlt = m_altitudeFt;
-    const double startAlt = centerAlt + spanFt/2.0;
-
-    // ticks every 50 ft, long every 100/200
-    p.setPen(hudPen(2.0));
-    QFont f = p.font();
-    f.setPointSizeF(r.height()*0.07);
-    p.setFont(f);
-
-    for (int ft = -500; ft <= 500; ft += 50) {
-        double alt = centerAlt + ft;
-        double y = inner.center().y() + (-ft * pxPerFt);
-
-        bool major = ((int)qRound(alt) % 200 == 0);
-        bool med   = ((int)qRound(alt) % 100 == 0);
-
-        double tickLen = major ? inner.width()*0.55 : (med ? inner.width()*0.40 : inner.width()*0.25);
-
-        p.drawLine(QPointF(inner.right() - tickLen, y), QPointF(inner.right(), y));
-
-        if (med) {
-            QString label = QString::number((int)qRound(alt/10.0)*10);
-            p.drawText(QRectF(inner.left(), y-10, inner.width()*0.60, 20),
-                       Qt::AlignLeft | Qt::AlignVCenter, label);
-        }
-    }
-
     // Current altitude readout box
-    QRectF box(r.left() + r.width()*0.20, r.center().y() - r.height()*0.07,
-               r.width()*0.60, r.height()*0.14);
-    p.setPen(hudPen(2.0));
-    p.drawRect(box);
-
-    QFont f2 = p.font();
-    f2.setPointSizeF(r.height()*0.12);
-    p.setFont(f2);
-    p.drawText(box, Qt::AlignCenter, QString::number((int)qRound(m_altitudeFt)));
+    p.drawRect(altitudeReadoutRect(r));
 
-    // "ALTITUDE" and vspeed text under (like screenshot)
+    // "ALTITUDE" label under (like screenshot)
     QFont f3 = p.font();
     f3.setPointSizeF(r.height()*0.07);
     p.setFont(f3);
     p.drawText(QRectF(r.left(), r.bottom()+4, r.width(), r.height()*0.22),
                Qt::AlignHCenter | Qt::AlignTop, "ALTITUDE");
 
-    QFont f4 = p.font();
-    f4.setPointSizeF(r.height()*0.07);
-    p.setFont(f4);
-    p.drawText(QRectF(r.left(), r.bottom()+r.height()*0.18, r.width(), r.height()*0.22),
-               Qt::AlignHCenter | Qt::AlignTop,
-               QString("%1 FPM").arg((int)qRound(m_vspeedFpm)));
+    p.restore();
+}
+
+void HudWidget::drawAltitudeTape(QPainter &p, const QRectF &r)
+{
+    p.save();
+    p.setPen(hudPen(2.0));
+    p.setBrush(Qt::NoBrush);
+
+    // Scrolling scale (+- 500 ft around current altitude)
+    m_altitudeStrip.draw(p, altitudeInnerRect(r), m_altitudeFt);
+
+    // Current altitude readout
+    p.setFont(m_txtAltReadout.font());
+    HudTextCache::draw(p, altitudeReadoutRect(r), Qt::AlignCenter,
+                       intText(m_txtAltReadout, qRound64(m_altitudeFt)));
+
+    // vspeed text under the "ALTITUDE" label
+    p.setFont(m_txtVspeed.font());
+    HudTextCache::draw(p, QRectF(r.left(), r.bottom()+r.height()*0.18, r.width(), r.height()*0.22),
+                       Qt::AlignHCenter | Qt::AlignTop,
+                       intText(m_txtVspeed, qRound64(m_vspeedFpm), " FPM"));
 
     p.restore();
 }
 
-void HudWidget::drawBottomReadouts(QPainter &p, const QRectF &r)
+void HudWidget::drawBottomFrame(QPainter &p, const QRectF &r)
 {
     p.save();
     p.setPen(hudPen(2.0));
@@ -301,27 +1042,34 @@ void HudWidget::drawBottomReadouts(QPainter &p, const QRectF &r)
 
     QFont label = p.font();
     label.setPointSizeF(r.height()*0.18);
-
-    QFont value = p.font();
-    value.setPointSizeF(r.height()*0.26);
-
-    // Left: Roll
     p.setFont(label);
+
+    // Left: Roll, right: Pitch
     p.drawText(QRectF(r.left(), r.top()+6, r.width()/2, r.height()*0.35),
                Qt::AlignHCenter | Qt::AlignVCenter, "ROLL");
-    p.setFont(value);
-    p.drawText(QRectF(r.left(), r.top()+r.height()*0.35, r.width()/2, r.height()*0.55),
-               Qt::AlignHCenter | Qt::AlignVCenter,
-               QString("%1°").arg(m_rollDeg, 0, 'f', 1));
-
-    // Right: Pitch
-    p.setFont(label);
     p.drawText(QRectF(r.center().x(), r.top()+6, r.width()/2, r.height()*0.35),
                Qt::AlignHCenter | Qt::AlignVCenter, "PITCH");
-    p.setFont(value);
-    p.drawText(QRectF(r.center().x(), r.top()+r.height()*0.35, r.width()/2, r.height()*0.55),
-               Qt::AlignHCenter | Qt::AlignVCenter,
-               QString("%1°").arg(m_pitchDeg, 0, 'f', 1));
+
+    p.restore();
+}
+
+void HudWidget::drawBottomReadouts(QPainter &p, const QRectF &r)
+{
+    p.save();
+    p.setPen(hudPen(2.0));
+    p.setBrush(Qt::NoBrush);
+
+    p.setFont(m_txtAttitudeReadout.font());
+
+    // Left: Roll
+    HudTextCache::draw(p, QRectF(r.left(), r.top()+r.height()*0.35, r.width()/2, r.height()*0.55),
+                       Qt::AlignHCenter | Qt::AlignVCenter,
+                       degreeText(m_txtAttitudeReadout, m_rollDeg));
+
+    // Right: Pitch
+    HudTextCache::draw(p, QRectF(r.center().x(), r.top()+r.height()*0.35, r.width()/2, r.height()*0.55),
+                       Qt::AlignHCenter | Qt::AlignVCenter,
+                       degreeText(m_txtAttitudeReadout, m_pitchDeg));
 
     p.restore();
 }
@@ -1,5 +1,24 @@
 #pragma once
 #include <QWidget>
+#include <QElapsedTimer>
+#include <QPixmap>
+#include <QRegion>
+#include <QThreadPool>
+#include "AttitudeRenderer.h"
+#include "FrameRecorder.h"
+#include "FramebufferOutput.h"
+#include "HudTapes.h"
+#include "HudText.h"
+#include "WarpMesh.h"
+#include "WarpRemap.h"
+
+#include <vector>
+
+class AttitudePredictor;
+class QualityGovernor;
+struct HudSample;
+
+class HudMirror;
 
 class HudWidget : public QWidget
 {
@@ -13,8 +32,104 @@ public:
     void setAltitudeFt(double ft);
     void setVSpeedFpm(double fpm);
 
+    // Update all instruments from one sample; only the instruments whose
+    // value changed are scheduled for repaint.
+    void setSample(const HudSample& s);
+
+    // When set, roll/pitch/heading are extrapolated to photon time at paint.
+    void setPredictor(AttitudePredictor* predictor) { m_predictor = predictor; }
+
+    // Outlines, fixed labels and icons are pre-rendered into a pixmap that is
+    // rebuilt on resize / theme / DPR change. Off = draw everything per frame.
+    void setStaticLayerEnabled(bool on);
+
+    // Vsync pacing (FrameScheduler): while on, changes only accumulate a
+    // dirty region, and renderPending() paints it synchronously once per
+    // refresh. Returns false when nothing changed since the last frame.
+    void setExternalPacing(bool on);
+    bool renderPending();
+    bool hasPendingFrame() const { return !m_pendingRegion.isEmpty(); }
+
+    // Stroke/text antialiasing of everything painted per frame and of the
+    // static layer (pre-rendered strips and sprites keep theirs). Default on.
+    void setAntialiasing(bool on);
+
+    // Wall time of each draw function in the last paintEvent, if enabled
+    // (render_bench). Icons only run per frame without the static layer.
+    struct SectionTimes {
+        double headingUs = 0, attitudeUs = 0, altitudeUs = 0, readoutsUs = 0, iconsUs = 0;
+        double warpUs = 0;   // with setWarp(), remap of the changed tiles
+    };
+    void setSectionTiming(bool on) { m_sectionTiming = on; }
+    SectionTimes lastSectionTimes() const { return m_sectionTimes; }
+
+    // Rasterize each changed instrument into its own image, in parallel on
+    // a worker pool (the GUI thread takes one), then composite them over
+    // the static layer. Unchanged instruments reuse their last image.
+    // Needs the static layer; without it painting stays serial.
+    // threads: pool size, 0 = cores - 1 (at most 3).
+    void setParallelRaster(bool on, int threads = 0);
+
+    // Render quality level, see QualityGovernor (0 = full). With a governor
+    // set, every paint's time is fed to it and its level is applied.
+    void setQualityLevel(int level);
+    int qualityLevel() const { return m_quality; }
+    void setQualityGovernor(QualityGovernor* governor) { m_governor = governor; }
+
+    // Projector / combiner correction: the frame is rendered into an image
+    // and remapped through the mesh (WarpRemap) on the way to the screen.
+    // Only output tiles that read repainted pixels are re-warped. An invalid
+    // mesh turns it off.
+    void setWarp(const WarpMesh &mesh);
+    bool warpEnabled() const { return m_warp; }
+
+    // Hand every painted frame (as sent to the screen, after the warp) to
+    // a FrameRecorder, with the displayed sample's timestamps. Paints go
+    // through the offscreen frame while set. A frame the recorder refuses
+    // is dropped; its dirty rects carry over to the next one.
+    void setRecorder(FrameRecorder *recorder);
+
+    // Present frames on a framebuffer / KMS output instead of the window
+    // (which is not shown). The widget takes the output's size and needs
+    // external pacing: renderPending() paints offscreen and present()s the
+    // repainted rects. Below full resolution they are scaled up first.
+    void setOutput(FramebufferOutput *output);
+
+    // Show the same frame on other screens. Paints go through the offscreen
+    // frame; after each one every mirror gets the repainted source rects and
+    // scales / warps just those, so nothing is drawn twice.
+    void addMirror(HudMirror *mirror);
+
+    // Tuning overlay (F3): FPS, frame-time sparkline, paint time per
+    // instrument, link health and sample age at display. Frame numbers are
+    // measured here; the link side comes from setPerfInput(). The panel is
+    // re-rendered into an image twice a second and only blitted in between.
+    struct PerfInput {
+        double samplesPerSec = 0.0;
+        double crcErrorPct = 0.0;    // of received frames
+        double lenErrorPct = 0.0;
+        int    queueDepth = -1;      // playout buffer, -1 = not in use
+    };
+    void setPerfOverlay(bool on);
+    bool perfOverlay() const { return m_perfOn; }
+    void setPerfInput(const PerfInput &in) { m_perfIn = in; }
+
+    // paintEvent wall time since the last call, and how many samples were
+    // dropped by change detection (nothing visible would have moved)
+    struct PaintStats {
+        int    frames = 0;
+        int    skipped = 0;
+        int    quality = 0;     // level at the time of the call
+        double meanUs = 0.0;
+        double maxUs  = 0.0;
+    };
+    PaintStats takePaintStats();
+
 protected:
     void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+    void changeEvent(QEvent *event) override;
+    void keyPressEvent(QKeyEvent *event) override;
 
 private:
     // State
@@ -24,11 +139,160 @@ private:
     double m_altitudeFt = 34959;
     double m_vspeedFpm  = -164;
 
-    // Drawing helpers
+    AttitudePredictor* m_predictor = nullptr;
+
+    // Static layer cache
+    QPixmap m_staticLayer;       // background, outlines, fixed labels, icons
+    QPixmap m_attitudeOverlay;   // circle outline + aircraft marker, drawn over the horizon
+    QRectF  m_attitudeOverlayRect;
+    bool    m_staticEnabled = true;
+    bool    m_staticDirty = true;
+
+    // Sized from the layout: text caches and pre-rendered tape strips
+    HudTextCache m_txtHeadingReadout;   // key: tenths of a degree
+    HudTextCache m_txtAltReadout;       // key: whole feet
+    HudTextCache m_txtVspeed;           // key: whole fpm
+    HudTextCache m_txtAttitudeReadout;  // roll + pitch, key: tenths of a degree
+    HeadingStrip  m_headingStrip;       // 0..359 / N E S W
+    AltitudeStrip m_altitudeStrip;      // 1000 ft bands
+    AttitudeRenderer m_attitudeRenderer; // ladder sprite + circle mask
+    qreal        m_sizedDpr = 0.0;
+    bool         m_sizedDirty = true;
+
+    // Rendered quantum of each displayed value for the current geometry:
+    // tape/ladder device-pixel offsets and readout strings. A sample that
+    // leaves all of an instrument's quanta unchanged doesn't repaint it.
+    struct Visual {
+        int    headingPx = 0;
+        qint64 headingTenths = 0;
+        qint64 rollStep = 0, pitchPx = 0;
+        qint64 rollTenths = 0, pitchTenths = 0;
+        qint64 altPx = 0, altFt = 0, vspeedFpm = 0;
+    };
+    Visual visual(double headingDeg, double rollDeg, double pitchDeg,
+                  double altitudeFt, double vspeedFpm) const;
+    Visual m_visual;
+    bool   m_visualValid = false;
+
+    bool    m_externalPacing = false;
+    QRegion m_pendingRegion;
+
+    // Parallel rasterization: per-instrument images, indexed by bit
+    struct InstrumentLayer {
+        QImage image;
+        QRect  rect;
+    };
+    InstrumentLayer m_layers[4];
+    int         m_layersDirty = 0xF;   // Instrument flags to re-render
+    bool        m_parallel = false;
+    QThreadPool m_pool;
+
+    // Quality level: per-frame AA, sprite filtering, internal resolution
+    QualityGovernor* m_governor = nullptr;
+    int     m_quality = 0;
+    double  m_renderScale = 1.0;
+    QImage  m_frame;              // offscreen frame (scaled down and/or warped)
+    bool    needsFrame() const {
+        return m_renderScale < 1.0 || m_warp || m_recorder || m_output || !m_mirrors.empty();
+    }
+    qreal   renderDpr() const { return devicePixelRatioF() * m_renderScale; }
+    bool    frameAntialias() const { return m_antialias && m_quality < 1; }
+
+    // Warp: m_frame (logical coordinates) -> m_warpOut (widget device pixels)
+    WarpMesh  m_warpMesh;
+    WarpRemap m_remap;
+    QImage    m_warpOut;
+    QRegion   m_warpSrcDirty;        // repainted source not yet warped
+    std::vector<uint8_t> m_warpMask; // per output tile
+    bool      m_warp = false;
+    bool      updateRemap();
+    QRegion   warpFootprint(const QRegion &source, std::vector<uint8_t> *mask) const;
+    void      warpFrame(const QRegion &source);
+
+    // Capture
+    FrameRecorder *m_recorder = nullptr;
+    QRegion   m_captureDirty;        // changed since the last accepted frame
+    std::vector<FrameRecorder::Rect> m_captureRects;
+    qint64    m_sampleTsUs = 0;
+    void      captureFrame(const QRegion &painted);
+
+    // Direct output
+    FramebufferOutput *m_output = nullptr;
+    QImage    m_outImage;            // upscaled frame below full resolution
+    std::vector<FramebufferOutput::Rect> m_outRects;
+    void      presentFrame(const QRegion &painted);
+
+    std::vector<HudMirror *> m_mirrors;
+
+    // Performance overlay
+    static constexpr int kPerfHistory = 120;
+    bool      m_perfOn = false;
+    PerfInput m_perfIn;
+    QImage    m_perfImage;
+    QRect     m_perfRect;
+    QElapsedTimer m_perfClock;
+    qint64    m_perfLastFrameNs = -1, m_perfLastBuildNs = 0;
+    float     m_perfIntervalMs[kPerfHistory] = {};
+    float     m_perfPaintMs[kPerfHistory] = {};
+    int       m_perfHead = 0, m_perfFilled = 0;
+    int       m_perfFrames = 0;                 // since the last rebuild
+    double    m_perfPaintSumUs = 0.0, m_perfPaintMaxUs = 0.0;
+    double    m_perfAgeSumUs = 0.0, m_perfAgeMaxUs = 0.0;
+    int       m_perfAgeCount = 0;
+    SectionTimes m_perfSections;                // summed since the last rebuild
+    qint64    m_sampleHostUs = 0;
+    bool      sectionTiming() const { return m_sectionTiming || m_perfOn; }
+    QRect     perfRect() const;
+    void      notePerfFrame(double paintUs);
+    void      rebuildPerfOverlay();
+
+    bool         m_antialias = true;
+    bool         m_sectionTiming = false;
+    SectionTimes m_sectionTimes;
+
+    // Paint timing
+    int    m_samplesSkipped = 0;
+    int    m_paintFrames = 0;
+    double m_paintSumUs = 0.0;
+    double m_paintMaxUs = 0.0;
+
+    // Layout (relative to window size)
+    struct Layout {
+        QRectF heading, attitude, altitude, bottom, icons;
+    };
+    Layout layout() const;
+
+    // Instruments with per-frame content, as dirty-region flags
+    enum Instrument {
+        HeadingInstrument  = 0x1,
+        AttitudeInstrument = 0x2,
+        AltitudeInstrument = 0x4,   // tape, readout and the FPM line below
+        ReadoutInstrument  = 0x8,   // roll / pitch values
+        AllInstruments     = 0xF
+    };
+    QRect instrumentRect(Instrument i, const Layout &l) const;
+    void markDirty(int instruments);
+    void markDirtyRegion(QRegion region);
+
+    void rasterizeLayers(const Layout &l, int wanted);
+    void renderLayer(int index, const Layout &l);
+
+    void rebuildStaticLayer();
+    void rebuildSizedCaches(const Layout &l);
+    void drawStatic(QPainter &p, const Layout &l);
+    void drawAttitudeOverlay(QPainter &p, const QRectF &r);
+
+    // Drawing helpers (dynamic parts)
     void drawHeadingTape(QPainter &p, const QRectF &r);
     void drawAttitude(QPainter &p, const QRectF &r);
     void drawAltitudeTape(QPainter &p, const QRectF &r);
     void drawBottomReadouts(QPainter &p, const QRectF &r);
+
+    // Drawing helpers (static parts)
+    void drawHeadingFrame(QPainter &p, const QRectF &r);
+    void drawAttitudeFrame(QPainter &p, const QRectF &r);
+    void drawAltitudeFrame(QPainter &p, const QRectF &r);
+    void drawBottomFrame(QPainter &p, const QRectF &r);
     void drawIconButtons(QPainter &p, const QRectF &r);
 
     static double wrap360(double deg);
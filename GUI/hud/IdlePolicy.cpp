@@ -0,0 +1,55 @@
+#include "IdlePolicy.h"
+
+#include <algorithm>
+
+void IdlePolicy::setDividers(int idle, int deep)
+{
+    m_idleDivider = std::max(1, idle);
+    m_deepDivider = std::max(m_idleDivider, deep);
+}
+
+// Time spent at a reduced rate, for the stats
+void IdlePolicy::account(int64_t nowUs)
+{
+    if (m_statsStartUs < 0) m_statsStartUs = nowUs;
+    if (m_accountedUs >= 0 && m_divider > 1) m_idleUs += nowUs - m_accountedUs;
+    m_accountedUs = nowUs;
+}
+
+int IdlePolicy::update(bool changed, int64_t nowUs)
+{
+    account(nowUs);
+    ++m_updates;
+    if (m_lastChangeUs < 0 || changed) {
+        if (changed && m_divider > 1) ++m_wakes;
+        m_lastChangeUs = nowUs;
+    }
+
+    const int64_t quiet = nowUs - m_lastChangeUs;
+    if (m_idleAfterUs <= 0 || quiet < m_idleAfterUs) m_divider = 1;
+    else if (quiet < m_deepAfterUs) m_divider = m_idleDivider;
+    else m_divider = m_deepDivider;
+    return m_divider;
+}
+
+void IdlePolicy::wake(int64_t nowUs)
+{
+    account(nowUs);
+    m_lastChangeUs = nowUs;
+    if (m_divider > 1) ++m_wakes;
+    m_divider = 1;
+}
+
+IdlePolicy::Stats IdlePolicy::takeStats(int64_t nowUs)
+{
+    account(nowUs);
+    Stats st;
+    const int64_t span = nowUs - m_statsStartUs;
+    st.idleFraction = span > 0 ? double(m_idleUs) / double(span) : 0.0;
+    st.updates = m_updates;
+    st.wakes = m_wakes;
+    m_statsStartUs = nowUs;
+    m_idleUs = 0;
+    m_updates = m_wakes = 0;
+    return st;
+}
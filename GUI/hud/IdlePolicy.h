@@ -0,0 +1,51 @@
+#pragma once
+#include <cstdint>
+
+// Drops the update rate while nothing visible changes.
+//
+// The caller runs at some base period (a display refresh for the HUD, the
+// 80 ms OLED tick) and reports after each update whether anything visibly
+// changed. After idleAfter without a change the policy asks for every
+// idleDivider-th period, after deepAfter for every deepDivider-th. The
+// first change, reported by update() or, between updates, by wake(), puts
+// it straight back to full rate; callers that can be woken by their data
+// should call wake() so motion is shown at the next base period rather
+// than the next idle one.
+
+class IdlePolicy {
+public:
+    struct Stats {
+        double idleFraction = 0.0;   // of the time since the last call
+        int    updates = 0;
+        int    wakes = 0;            // idle -> full rate transitions
+    };
+
+    // 0 disables idling
+    void setIdleAfterUs(int64_t us) { m_idleAfterUs = us; }
+    void setDeepAfterUs(int64_t us) { m_deepAfterUs = us; }
+    void setDividers(int idle, int deep);
+
+    // After an update; returns how many base periods until the next one
+    int update(bool changed, int64_t nowUs);
+    // A visible change arrived between updates
+    void wake(int64_t nowUs);
+
+    int divider() const { return m_divider; }
+    bool idle() const { return m_divider > 1; }
+
+    Stats takeStats(int64_t nowUs);
+
+private:
+    void account(int64_t nowUs);
+
+    int64_t m_idleAfterUs = 2000000;
+    int64_t m_deepAfterUs = 10000000;
+    int     m_idleDivider = 6;
+    int     m_deepDivider = 30;
+
+    int64_t m_lastChangeUs = -1;
+    int     m_divider = 1;
+
+    int64_t m_statsStartUs = -1, m_accountedUs = -1, m_idleUs = 0;
+    int     m_updates = 0, m_wakes = 0;
+};
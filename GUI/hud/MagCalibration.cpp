@@ -0,0 +1,223 @@
+#include "MagCalibration.h"
+
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+bool MagCalibration::load(const std::string& path)
+{
+    std::ifstream in(path);
+    if (!in) return false;
+
+    MagCalibration c;
+    bool haveOffset = false, haveMatrix = false;
+    std::string line;
+    while (std::getline(in, line)) {
+        std::istringstream ls(line);
+        std::string key;
+        if (!(ls >> key) || key[0] == '#') continue;
+
+        if (key == "offset") {
+            haveOffset = bool(ls >> c.offset[0] >> c.offset[1] >> c.offset[2]);
+        } else if (key == "matrix") {
+            haveMatrix = true;
+            for (int i = 0; i < 9; ++i) {
+                if (!(ls >> c.matrix[i / 3][i % 3])) haveMatrix = false;
+            }
+        }
+    }
+    if (!haveOffset || !haveMatrix) return false;
+
+    c.valid = true;
+    *this = c;
+    return true;
+}
+
+bool MagCalibration::save(const std::string& path) const
+{
+    std::ofstream out(path);
+    if (!out) return false;
+
+    out.precision(9);
+    out << "# PEGASUS magnetometer calibration: m' = matrix * (m - offset)\n";
+    out << "offset " << offset[0] << ' ' << offset[1] << ' ' << offset[2] << '\n';
+    out << "matrix";
+    for (int i = 0; i < 3; ++i)
+        for (int j = 0; j < 3; ++j) out << ' ' << matrix[i][j];
+    out << '\n';
+    return bool(out);
+}
+
+void MagCalibrator::reset()
+{
+    *this = MagCalibrator();
+}
+
+void MagCalibrator::add(double mx, double my, double mz)
+{
+    if (m_n == 0) {
+        m_scale = std::sqrt(mx*mx + my*my + mz*mz);
+        if (m_scale <= 0.0) return;
+        m_min[0] = m_max[0] = mx;
+        m_min[1] = m_max[1] = my;
+        m_min[2] = m_max[2] = mz;
+    }
+
+    const double v[3] = { mx, my, mz };
+    for (int a = 0; a < 3; ++a) {
+        if (v[a] < m_min[a]) m_min[a] = v[a];
+        if (v[a] > m_max[a]) m_max[a] = v[a];
+    }
+
+    const double x = mx / m_scale, y = my / m_scale, z = mz / m_scale;
+    const double d[9] = { x*x, y*y, z*z, 2*x*y, 2*x*z, 2*y*z, 2*x, 2*y, 2*z };
+
+    // Upper triangle only; fit() mirrors it
+    for (int i = 0; i < 9; ++i) {
+        m_Dt1[i] += d[i];
+        for (int j = i; j < 9; ++j) m_DtD[i][j] += d[i] * d[j];
+    }
+    m_n++;
+}
+
+// Gaussian elimination with partial pivoting on an n x n system (n <= 9).
+static bool solveLinear(double A[9][9], double b[9], double x[9], int n)
+{
+    for (int c = 0; c < n; ++c) {
+        int piv = c;
+        for (int r = c + 1; r < n; ++r)
+            if (std::fabs(A[r][c]) > std::fabs(A[piv][c])) piv = r;
+        if (std::fabs(A[piv][c]) < 1e-12) return false;
+
+        if (piv != c) {
+            for (int k = 0; k < n; ++k) std::swap(A[c][k], A[piv][k]);
+            std::swap(b[c], b[piv]);
+        }
+        for (int r = c + 1; r < n; ++r) {
+            const double f = A[r][c] / A[c][c];
+            for (int k = c; k < n; ++k) A[r][k] -= f * A[c][k];
+            b[r] -= f * b[c];
+        }
+    }
+    for (int r = n - 1; r >= 0; --r) {
+        double s = b[r];
+        for (int k = r + 1; k < n; ++k) s -= A[r][k] * x[k];
+        x[r] = s / A[r][r];
+    }
+    return true;
+}
+
+// Cyclic Jacobi eigen-decomposition of a symmetric 3x3: A = V diag(e) V^T
+static void eigenSym3(const double Ain[3][3], double e[3], double V[3][3])
+{
+    double A[3][3];
+    for (int i = 0; i < 3; ++i)
+        for (int j = 0; j < 3; ++j) {
+            A[i][j] = Ain[i][j];
+            V[i][j] = (i == j) ? 1.0 : 0.0;
+        }
+
+    for (int sweep = 0; sweep < 50; ++sweep) {
+        const double off = A[0][1]*A[0][1] + A[0][2]*A[0][2] + A[1][2]*A[1][2];
+        if (off < 1e-30) break;
+
+        for (int p = 0; p < 2; ++p) {
+            for (int q = p + 1; q < 3; ++q) {
+                if (std::fabs(A[p][q]) < 1e-300) continue;
+                const double theta = (A[q][q] - A[p][p]) / (2.0 * A[p][q]);
+                const double t = (theta >= 0 ? 1.0 : -1.0) /
+                                 (std::fabs(theta) + std::sqrt(theta*theta + 1.0));
+                const double c = 1.0 / std::sqrt(t*t + 1.0);
+                const double s = t * c;
+
+                for (int k = 0; k < 3; ++k) {
+                    const double akp = A[k][p], akq = A[k][q];
+                    A[k][p] = c*akp - s*akq;
+                    A[k][q] = s*akp + c*akq;
+                }
+                for (int k = 0; k < 3; ++k) {
+                    const double apk = A[p][k], aqk = A[q][k];
+                    A[p][k] = c*apk - s*aqk;
+                    A[q][k] = s*apk + c*aqk;
+                }
+                for (int k = 0; k < 3; ++k) {
+                    const double vkp = V[k][p], vkq = V[k][q];
+                    V[k][p] = c*vkp - s*vkq;
+                    V[k][q] = s*vkp + c*vkq;
+                }
+            }
+        }
+    }
+    for (int i = 0; i < 3; ++i) e[i] = A[i][i];
+}
+
+bool MagCalibrator::fit(MagCalibration& out, double* rmsResidual) const
+{
+    if (m_n < 9) return false;
+
+    double A[9][9], b[9], v[9];
+    for (int i = 0; i < 9; ++i) {
+        b[i] = m_Dt1[i];
+        for (int j = 0; j < 9; ++j) A[i][j] = (j >= i) ? m_DtD[i][j] : m_DtD[j][i];
+    }
+    if (!solveLinear(A, b, v, 9)) return false;
+
+    if (rmsResidual) {
+        // sum (D v - 1)^2 = v' DtD v - 2 v' Dt1 + n, all from the running sums
+        double vAv = 0.0, vb = 0.0;
+        for (int i = 0; i < 9; ++i) {
+            vb += v[i] * m_Dt1[i];
+            for (int j = 0; j < 9; ++j)
+                vAv += v[i] * v[j] * ((j >= i) ? m_DtD[i][j] : m_DtD[j][i]);
+        }
+        const double ss = vAv - 2.0 * vb + double(m_n);
+        *rmsResidual = std::sqrt(std::fmax(ss, 0.0) / double(m_n));
+    }
+
+    // Quadric form Q and linear term g:  x'Qx + 2g'x = 1
+    const double Q[3][3] = { { v[0], v[3], v[4] },
+                             { v[3], v[1], v[5] },
+                             { v[4], v[5], v[2] } };
+    const double g[3] = { v[6], v[7], v[8] };
+
+    // Center c = -Q^-1 g
+    double Q9[9][9] = {}, rhs[9] = {}, c[9] = {};
+    for (int i = 0; i < 3; ++i) {
+        rhs[i] = -g[i];
+        for (int j = 0; j < 3; ++j) Q9[i][j] = Q[i][j];
+    }
+    if (!solveLinear(Q9, rhs, c, 3)) return false;
+
+    // (x-c)' M (x-c) = 1 with M = Q / (1 + c'Qc)
+    double cQc = 0.0;
+    for (int i = 0; i < 3; ++i)
+        for (int j = 0; j < 3; ++j) cQc += c[i] * Q[i][j] * c[j];
+    const double k = 1.0 + cQc;
+    if (k <= 0.0) return false;
+
+    double M[3][3];
+    for (int i = 0; i < 3; ++i)
+        for (int j = 0; j < 3; ++j) M[i][j] = Q[i][j] / k;
+
+    double e[3], V[3][3];
+    eigenSym3(M, e, V);
+    if (e[0] <= 0.0 || e[1] <= 0.0 || e[2] <= 0.0) return false;   // not an ellipsoid
+
+    // W = r * M^(1/2): maps the ellipsoid onto a sphere whose radius r is the
+    // geometric mean of the semi-axes, so field strength stays in sensor units.
+    const double r = std::cbrt(1.0 / std::sqrt(e[0] * e[1] * e[2]));
+    const double s[3] = { std::sqrt(e[0]), std::sqrt(e[1]), std::sqrt(e[2]) };
+
+    MagCalibration cal;
+    for (int i = 0; i < 3; ++i) {
+        cal.offset[i] = c[i] * m_scale;
+        for (int j = 0; j < 3; ++j) {
+            double w = 0.0;
+            for (int k2 = 0; k2 < 3; ++k2) w += V[i][k2] * s[k2] * V[j][k2];
+            cal.matrix[i][j] = r * w;
+        }
+    }
+    cal.valid = true;
+    out = cal;
+    return true;
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include <string>
+
+// Hard/soft-iron magnetometer correction: m' = W * (m - b)
+// W is the precomputed 3x3 soft-iron matrix, b the hard-iron offset.
+struct MagCalibration {
+    double offset[3] = {0, 0, 0};
+    double matrix[3][3] = {{1,0,0},{0,1,0},{0,0,1}};
+    bool   valid = false;
+
+    void apply(double& mx, double& my, double& mz) const {
+        const double x = mx - offset[0];
+        const double y = my - offset[1];
+        const double z = mz - offset[2];
+        mx = matrix[0][0]*x + matrix[0][1]*y + matrix[0][2]*z;
+        my = matrix[1][0]*x + matrix[1][1]*y + matrix[1][2]*z;
+        mz = matrix[2][0]*x + matrix[2][1]*y + matrix[2][2]*z;
+    }
+
+    // Plain text: "offset bx by bz" / "matrix w00 .. w22". Returns false on error.
+    bool load(const std::string& path);
+    bool save(const std::string& path) const;
+};
+
+// Streaming ellipsoid fit. Each add() folds the sample into the 9x9 normal
+// equations of  Ax^2+By^2+Cz^2+2Dxy+2Exz+2Fyz+2Gx+2Hy+2Iz = 1,
+// so memory is fixed no matter how long the unit is waved around.
+class MagCalibrator {
+public:
+    void reset();
+    void add(double mx, double my, double mz);
+
+    long long count() const { return m_n; }
+
+    // Per-axis span seen so far (max - min), a rough coverage indicator.
+    double span(int axis) const { return m_n ? m_max[axis] - m_min[axis] : 0.0; }
+
+    // Solve for the ellipsoid. Fails if the system is singular or the quadric
+    // is not an ellipsoid (typically: not enough orientations covered).
+    // rmsResidual (optional) is the algebraic fit residual, ~0 for a clean fit.
+    bool fit(MagCalibration& out, double* rmsResidual = nullptr) const;
+
+private:
+    double m_DtD[9][9] = {};
+    double m_Dt1[9] = {};
+    long long m_n = 0;
+
+    // Samples are divided by this before accumulation to keep the sums well
+    // conditioned; set from the first sample.
+    double m_scale = 0.0;
+    double m_min[3] = {0, 0, 0};
+    double m_max[3] = {0, 0, 0};
+};
@@ -0,0 +1,106 @@
+#include "PlayoutBuffer.h"
+#include "SteadyClock.h"
+
+PlayoutBuffer::PlayoutBuffer(QObject* parent) : QObject(parent)
+{
+    m_timer.setSingleShot(true);
+    m_timer.setTimerType(Qt::PreciseTimer);
+    connect(&m_timer, &QTimer::timeout, this, &PlayoutBuffer::onTimeout);
+}
+
+void PlayoutBuffer::clear()
+{
+    m_timer.stop();
+    m_head = 0;
+    m_count = 0;
+    m_haveOffset = false;
+    m_peakJitterUs = 0;
+}
+
+qint64 PlayoutBuffer::targetDelayUs() const
+{
+    const qint64 delay = qint64(m_peakJitterUs) + m_extraDelayUs;
+    return delay > m_maxDelayUs ? m_maxDelayUs : delay;
+}
+
+qint64 PlayoutBuffer::dueUs(const HudSample& s) const
+{
+    return s.tsUs + m_minOffsetUs + targetDelayUs();
+}
+
+void PlayoutBuffer::push(const HudSample& s)
+{
+    // Nothing to schedule by; pass straight through
+    if (s.tsUs == 0) {
+        m_played++;
+        emit sampleReady(s);
+        return;
+    }
+
+    const qint64 arrival = steadyNowUs();
+    const qint64 offset = arrival - s.tsUs;
+
+    // Device clock went backwards (ESP32 reset): start over
+    if (m_haveOffset && s.tsUs < m_lastTsUs) clear();
+
+    // Least-buffered offset, leaking up at 100 ppm to follow clock drift
+    if (m_haveOffset) m_minOffsetUs += (s.tsUs - m_lastTsUs) / 10000;
+    if (!m_haveOffset || offset < m_minOffsetUs) {
+        m_minOffsetUs = offset;
+        m_haveOffset = true;
+    }
+    m_lastTsUs = s.tsUs;
+
+    // Fast attack, ~2 s release (at ~100 Hz) peak follower on jitter
+    m_jitterUs = offset - m_minOffsetUs;
+    if (m_jitterUs > m_peakJitterUs) m_peakJitterUs = double(m_jitterUs);
+    else m_peakJitterUs += 0.005 * (double(m_jitterUs) - m_peakJitterUs);
+
+    if (m_count == kCapacity) {
+        // Drop the oldest rather than stall
+        m_head = (m_head + 1) % kCapacity;
+        m_count--;
+        m_overflows++;
+    }
+    m_ring[(m_head + m_count) % kCapacity] = s;
+    m_count++;
+
+    if (arrival >= dueUs(s)) m_underruns++;
+
+    onTimeout();
+}
+
+void PlayoutBuffer::onTimeout()
+{
+    const qint64 now = steadyNowUs();
+    while (m_count > 0 && dueUs(m_ring[m_head]) <= now) {
+        const HudSample s = m_ring[m_head];
+        m_head = (m_head + 1) % kCapacity;
+        m_count--;
+        m_played++;
+        emit sampleReady(s);
+    }
+    schedule();
+}
+
+void PlayoutBuffer::schedule()
+{
+    if (m_count == 0) {
+        m_timer.stop();
+        return;
+    }
+    const qint64 waitUs = dueUs(m_ring[m_head]) - steadyNowUs();
+    m_timer.start(int(qMax<qint64>(0, (waitUs + 999) / 1000)));
+}
+
+PlayoutBuffer::Stats PlayoutBuffer::stats() const
+{
+    Stats st;
+    st.targetDelayMs = targetDelayUs() / 1000.0;
+    st.jitterMs = m_jitterUs / 1000.0;
+    st.depth = m_count;
+    st.played = m_played;
+    st.underruns = m_underruns;
+    st.overflows = m_overflows;
+    return st;
+}
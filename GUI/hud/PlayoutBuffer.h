@@ -0,0 +1,68 @@
+#pragma once
+#include <QObject>
+#include <QTimer>
+#include "HudSample.h"
+
+// Timestamp-driven jitter buffer.
+//
+// The CP2102 hands frames over in bursts, so arrival time is a poor clock.
+// Samples are instead released at  ts_us + offset + delay,  where offset is
+// the smallest (arrival - ts_us) seen (the least-buffered path) and delay is
+// an adaptive target that follows the observed arrival jitter: it jumps up
+// to a new peak immediately and decays slowly when the link is calm.
+// extraDelay adds a fixed margin on top for users who prefer smoothness
+// over latency.
+//
+// A sample that arrives after its release time is played immediately and
+// counted as an underrun.
+
+class PlayoutBuffer : public QObject {
+    Q_OBJECT
+public:
+    struct Stats {
+        double targetDelayMs = 0;   // adaptive delay currently applied
+        double jitterMs = 0;        // latest arrival jitter
+        int    depth = 0;           // samples waiting
+        quint64 played = 0;
+        quint64 underruns = 0;
+        quint64 overflows = 0;      // dropped because the ring was full
+    };
+
+    explicit PlayoutBuffer(QObject* parent = nullptr);
+
+    void setExtraDelayUs(qint64 us) { m_extraDelayUs = us; }
+    void setMaxDelayUs(qint64 us)   { m_maxDelayUs = us; }
+
+    void push(const HudSample& s);
+    void clear();
+
+    Stats stats() const;
+
+signals:
+    void sampleReady(const HudSample& s);
+
+private slots:
+    void onTimeout();
+
+private:
+    void schedule();
+    qint64 targetDelayUs() const;
+    qint64 dueUs(const HudSample& s) const;
+
+    static constexpr int kCapacity = 64;
+    HudSample m_ring[kCapacity];
+    int m_head = 0, m_count = 0;
+
+    QTimer m_timer;
+
+    qint64 m_minOffsetUs = 0;
+    qint64 m_lastTsUs = 0;
+    bool   m_haveOffset = false;
+
+    qint64 m_jitterUs = 0;
+    double m_peakJitterUs = 0;
+    qint64 m_extraDelayUs = 2000;
+    qint64 m_maxDelayUs = 100000;
+
+    quint64 m_played = 0, m_underruns = 0, m_overflows = 0;
+};
@@ -0,0 +1,53 @@
+#include "QualityGovernor.h"
+
+#include <algorithm>
+
+int QualityGovernor::addFrame(double frameUs)
+{
+    m_window.push_back(frameUs);
+    if ((int)m_window.size() < kWindow) return m_level;
+
+    const size_t k = m_window.size() * 9 / 10;
+    std::nth_element(m_window.begin(), m_window.begin() + k, m_window.end());
+    m_lastP90Us = m_window[k];
+    m_window.clear();
+
+    if (m_sinceUp >= 0) ++m_sinceUp;
+
+    if (m_lastP90Us > m_budgetUs) {
+        m_calmWindows = 0;
+        if (m_sinceUp == 1) m_upWindows = std::min(m_upWindows * 2, kMaxUpWindows);
+        m_sinceUp = -1;
+        if (m_level + 1 < kLevels) {
+            ++m_level;
+            ++m_stepsDown;
+        }
+    } else if (m_lastP90Us < m_budgetUs * m_headroom && m_level > 0) {
+        if (++m_calmWindows >= m_upWindows) {
+            m_calmWindows = 0;
+            m_sinceUp = 0;
+            --m_level;
+            ++m_stepsUp;
+        }
+    } else {
+        m_calmWindows = 0;
+    }
+
+    // A step up that held for a while: be quick to try the next one
+    if (m_sinceUp > kUpWindows) {
+        m_upWindows = kUpWindows;
+        m_sinceUp = -1;
+    }
+    return m_level;
+}
+
+QualityGovernor::Stats QualityGovernor::takeStats()
+{
+    Stats st;
+    st.level = m_level;
+    st.stepsDown = m_stepsDown;
+    st.stepsUp = m_stepsUp;
+    st.lastP90Us = m_lastP90Us;
+    m_stepsDown = m_stepsUp = 0;
+    return st;
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <vector>
+
+// Trades HUD render quality for frame time.
+//
+// Levels (applied by HudWidget::setQualityLevel):
+//   0  full quality
+//   1  no antialiasing on per-frame strokes/text, attitude sprite rotated
+//      without bilinear filtering
+//   2  rendered at 75% resolution and scaled up to the output
+//   3  rendered at 50% resolution
+//
+// Paint times are judged in windows of kWindow frames. A window whose p90
+// is over budget steps one level down straight away; kUpWindows windows in
+// a row with p90 under headroom * budget step one level back up. If that
+// level is over budget again right away, the number of calm windows needed
+// doubles (up to kMaxUpWindows) so the level doesn't flap.
+
+class QualityGovernor {
+public:
+    static constexpr int kLevels = 4;
+    static constexpr int kWindow = 30;
+    static constexpr int kUpWindows = 4;
+    static constexpr int kMaxUpWindows = 64;
+
+    struct Stats {
+        int    level = 0;
+        int    stepsDown = 0;
+        int    stepsUp = 0;
+        double lastP90Us = 0;
+    };
+
+    void setBudgetUs(double us)    { m_budgetUs = us; }
+    void setHeadroom(double frac)  { m_headroom = frac; }
+    double budgetUs() const        { return m_budgetUs; }
+
+    // Record one frame; returns the level to render the next one at
+    int addFrame(double frameUs);
+    int level() const { return m_level; }
+
+    // Snapshot; step counters restart
+    Stats takeStats();
+
+private:
+    std::vector<double> m_window;
+    double m_budgetUs = 12000.0;
+    double m_headroom = 0.5;
+    int    m_level = 0;
+    int    m_calmWindows = 0;
+    int    m_upWindows = kUpWindows;   // calm windows needed to step up
+    int    m_sinceUp = -1;             // windows since the last step up
+
+    int    m_stepsDown = 0, m_stepsUp = 0;
+    double m_lastP90Us = 0;
+};
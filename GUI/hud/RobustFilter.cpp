@@ -0,0 +1,155 @@
+#include "RobustFilter.h"
+
+#include <algorithm>
+#include <cmath>
+
+// Samples the sigma floor averages over
+static constexpr double kSigmaAvgSamples = 64.0;
+
+// Makes the MAD of n Gaussian samples unbiased (Croux & Rousseeuw 1992)
+static double madCorrection(int n)
+{
+    static const double small[10] = { 1.0, 1.0, 1.196, 1.495, 1.363, 1.206, 1.200, 1.140, 1.129, 1.107 };
+    return n < 10 ? small[n] : n / (n - 0.8);
+}
+
+void RunningMedian::setWindow(int window)
+{
+    if (window < 1) window = 1;
+    if (window > kMaxWindow) window = kMaxWindow;
+
+    m_n = window;
+    m_mid = window / 2;
+    m_idx = 0;
+    m_ct = 0;
+
+    // Pre-place every ring slot alternately into the upper/lower heaps so
+    // pushes during warm-up take the same path as steady state.
+    for (int k = window - 1; k >= 0; --k) {
+        m_pos[k] = ((k + 1) / 2) * ((k & 1) ? -1 : 1);
+        m_heap[m_pos[k] + m_mid] = k;
+        m_data[k] = 0.0;
+    }
+}
+
+void RunningMedian::exchange(int i, int j)
+{
+    int& a = m_heap[i + m_mid];
+    int& b = m_heap[j + m_mid];
+    const int t = a; a = b; b = t;
+    m_pos[a] = i;
+    m_pos[b] = j;
+}
+
+bool RunningMedian::cmpExchange(int i, int j)
+{
+    if (!less(i, j)) return false;
+    exchange(i, j);
+    return true;
+}
+
+// Sift-down helpers start at child position i and compare it with its
+// parent. Positions 1 and -1 are both children of the median slot 0, so
+// they are never treated as siblings of each other.
+void RunningMedian::minSortDown(int i)
+{
+    for (; i <= minCount(); i *= 2) {
+        if (i > 1 && i < minCount() && less(i + 1, i)) ++i;
+        if (!cmpExchange(i, i / 2)) break;
+    }
+}
+
+void RunningMedian::maxSortDown(int i)
+{
+    for (; i >= -maxCount(); i *= 2) {
+        if (i < -1 && i > -maxCount() && less(i, i - 1)) --i;
+        if (!cmpExchange(i / 2, i)) break;
+    }
+}
+
+// Sift up through the min-heap; true if the item reached the median slot
+bool RunningMedian::minSortUp(int i)
+{
+    while (i > 0 && cmpExchange(i, i / 2)) i /= 2;
+    return i == 0;
+}
+
+bool RunningMedian::maxSortUp(int i)
+{
+    while (i < 0 && cmpExchange(i / 2, i)) i /= 2;
+    return i == 0;
+}
+
+void RunningMedian::push(double v)
+{
+    const bool isNew = (m_ct < m_n);
+    const int p = m_pos[m_idx];
+    const double old = m_data[m_idx];
+
+    m_data[m_idx] = v;
+    m_idx = (m_idx + 1) % m_n;
+    if (isNew) m_ct++;
+
+    if (p > 0) {            // slot lives in the min-heap
+        if (!isNew && old < v) minSortDown(p * 2);
+        else if (minSortUp(p)) maxSortDown(-1);
+    } else if (p < 0) {     // slot lives in the max-heap
+        if (!isNew && v < old) maxSortDown(p * 2);
+        else if (maxSortUp(p)) minSortDown(1);
+    } else {                // slot is the median
+        if (maxCount()) maxSortDown(-1);
+        if (minCount()) minSortDown(1);
+    }
+}
+
+double RunningMedian::median() const
+{
+    if (m_ct == 0) return 0.0;
+    double v = itemAt(0);
+    if ((m_ct & 1) == 0) v = 0.5 * (v + itemAt(-1));
+    return v;
+}
+
+void HampelFilter::configure(int window, double k, double minSigma)
+{
+    m_med.setWindow(window);
+    m_k = k;
+    m_minSigma = minSigma;
+    m_sigmaAvg = 0.0;
+    m_rejected = 0;
+}
+
+double HampelFilter::mad(double med) const
+{
+    const int n = m_med.count();
+    const double* v = m_med.values();
+    double dev[RunningMedian::kMaxWindow];
+    for (int i = 0; i < n; ++i) dev[i] = std::fabs(v[i] - med);
+
+    const int h = n / 2;
+    std::nth_element(dev, dev + h, dev + n);
+    if (n & 1) return dev[h];
+    return 0.5 * (dev[h] + *std::max_element(dev, dev + h));
+}
+
+double HampelFilter::filter(double x)
+{
+    m_med.push(x);
+    const double med = m_med.median();
+    if (m_k <= 0.0) return med;
+
+    const double dev = std::fabs(x - med);
+
+    // 1.4826 * MAD estimates sigma for Gaussian noise
+    double sigma = madCorrection(m_med.count()) * 1.4826 * mad(med);
+    if (m_sigmaAvg == 0.0) m_sigmaAvg = sigma;
+    else m_sigmaAvg += (sigma - m_sigmaAvg) / kSigmaAvgSamples;
+    if (sigma < m_sigmaAvg) sigma = m_sigmaAvg;
+    if (sigma < m_minSigma) sigma = m_minSigma;
+
+    if (dev > m_k * sigma) {
+        m_rejected++;
+        return med;
+    }
+    return x;
+}
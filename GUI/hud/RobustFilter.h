@@ -0,0 +1,82 @@
+#pragma once
+
+// Running median over a sliding window, O(log n) per update.
+//
+// Two heaps share one fixed array around a centre slot (max-heap of the lower
+// half at negative positions, min-heap of the upper half at positive ones,
+// the median at 0), and every window slot knows its heap position. The
+// sample leaving the window is therefore replaced in place and sifted,
+// with no search and no allocation.
+class RunningMedian {
+public:
+    static constexpr int kMaxWindow = 64;
+
+    explicit RunningMedian(int window = 5) { setWindow(window); }
+
+    // Also clears the window. Clamped to [1, kMaxWindow].
+    void setWindow(int window);
+    int window() const { return m_n; }
+    void reset() { setWindow(m_n); }
+
+    void push(double v);
+    double median() const;
+    int count() const { return m_ct; }
+    // Window contents, count() of them, in ring (not sorted) order
+    const double* values() const { return m_data; }
+
+private:
+    double& itemAt(int heapPos)             { return m_data[m_heap[heapPos + m_mid]]; }
+    double  itemAt(int heapPos) const       { return m_data[m_heap[heapPos + m_mid]]; }
+    bool less(int i, int j) const           { return itemAt(i) < itemAt(j); }
+    void exchange(int i, int j);
+    bool cmpExchange(int i, int j);
+
+    int minCount() const { return (m_ct - 1) / 2; }
+    int maxCount() const { return m_ct / 2; }
+
+    void minSortDown(int i);
+    void maxSortDown(int i);
+    bool minSortUp(int i);
+    bool maxSortUp(int i);
+
+    double m_data[kMaxWindow];   // ring of window values
+    int    m_pos[kMaxWindow];    // heap position of each ring slot
+    int    m_heap[kMaxWindow];   // ring slot at each heap position (offset by m_mid)
+    int    m_n = 1;
+    int    m_mid = 0;
+    int    m_idx = 0;
+    int    m_ct = 0;
+};
+
+// Hampel outlier rejection: a sample more than k scaled MADs from the window
+// median is replaced by the median. The MAD is the median of |x_i - median|
+// over the current window (an O(n) selection on at most 64 values), scaled
+// to sigma with the small-sample correction. A MAD of 5..15 samples swings
+// far enough below sigma that k = 3 would still reject a few percent of
+// clean Gaussian data, so sigma never drops below its average over the last
+// ~64 samples; a manoeuvre raises the window MAD and still widens the gate
+// at once. Clean data then loses about 0.3% to the median, as k = 3 should.
+// k <= 0 turns it into a plain running median (always outputs the median).
+class HampelFilter {
+public:
+    explicit HampelFilter(int window = 7, double k = 3.0, double minSigma = 0.0)
+        : m_med(window), m_k(k), m_minSigma(minSigma) {}
+
+    void configure(int window, double k, double minSigma);
+    void reset() { m_med.reset(); m_sigmaAvg = 0.0; m_rejected = 0; }
+
+    // Returns the filtered value (x itself, or the median if x is an outlier).
+    double filter(double x);
+
+    double median() const { return m_med.median(); }
+    unsigned long long rejected() const { return m_rejected; }
+
+private:
+    double mad(double med) const;
+
+    RunningMedian m_med;
+    double m_k;
+    double m_minSigma;
+    double m_sigmaAvg = 0.0;
+    unsigned long long m_rejected = 0;
+};
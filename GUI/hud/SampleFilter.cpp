@@ -0,0 +1,166 @@
+#include "SampleFilter.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <sstream>
+
+static double HudSample::* const kFieldPtr[SampleFilter::kFieldCount] = {
+    &HudSample::headingDeg, &HudSample::rollDeg, &HudSample::pitchDeg,
+    &HudSample::altitudeFt, &HudSample::vspeedFpm,
+    &HudSample::ax, &HudSample::ay, &HudSample::az,
+    &HudSample::gx, &HudSample::gy, &HudSample::gz,
+    &HudSample::mx, &HudSample::my, &HudSample::mz,
+    &HudSample::pressureHpa, &HudSample::tempC,
+};
+
+static const char* const kFieldNames[SampleFilter::kFieldCount] = {
+    "heading", "roll", "pitch", "alt", "vs",
+    "ax", "ay", "az", "gx", "gy", "gz", "mx", "my", "mz",
+    "p", "T",
+};
+
+enum { F_HEADING, F_ROLL, F_PITCH, F_ALT, F_VS,
+       F_AX, F_AY, F_AZ, F_GX, F_GY, F_GZ, F_MX, F_MY, F_MZ,
+       F_P, F_T };
+
+const char* SampleFilter::fieldName(int field)
+{
+    return (field >= 0 && field < kFieldCount) ? kFieldNames[field] : "";
+}
+
+SampleFilter::SampleFilter()
+{
+    m_fields[F_HEADING].circular = true;
+    m_fields[F_ROLL].circular = true;
+
+    // Defaults: short Hampel windows on the raw sensors. They pass clean data
+    // through (no lag; only the ~0.3% 3-sigma tail goes to the median) and
+    // swap isolated spikes for the median.
+    auto hampel = [](double minSigma) {
+        FieldConfig c;
+        c.mode = Mode::Hampel;
+        c.window = 7;
+        c.k = 3.0;
+        c.minSigma = minSigma;
+        return c;
+    };
+    for (int f = F_AX; f <= F_AZ; ++f) setField(f, hampel(0.3));    // m/s^2
+    for (int f = F_GX; f <= F_GZ; ++f) setField(f, hampel(0.02));   // rad/s
+    for (int f = F_MX; f <= F_MZ; ++f) setField(f, hampel(1.0));    // uT
+    setField(F_ALT, hampel(2.0));                                   // ft
+    setField(F_P,   hampel(0.05));                                  // hPa
+    setField(F_T,   hampel(0.2));                                   // C
+}
+
+void SampleFilter::setField(int field, const FieldConfig& cfg)
+{
+    if (field < 0 || field >= kFieldCount) return;
+    Field& f = m_fields[field];
+    f.cfg = cfg;
+    f.filter.configure(cfg.window, cfg.mode == Mode::Median ? 0.0 : cfg.k, cfg.minSigma);
+    f.haveRef = false;
+}
+
+void SampleFilter::reset()
+{
+    for (Field& f : m_fields) {
+        f.filter.reset();
+        f.haveRef = false;
+    }
+}
+
+bool SampleFilter::configure(const std::string& spec, std::string* error)
+{
+    std::istringstream in(spec);
+    std::string item;
+    while (std::getline(in, item, ',')) {
+        if (item.empty()) continue;
+
+        if (item == "none") {
+            for (int f = 0; f < kFieldCount; ++f) setField(f, FieldConfig());
+            continue;
+        }
+
+        const size_t eq = item.find('=');
+        if (eq == std::string::npos) {
+            if (error) *error = "expected name=mode in '" + item + "'";
+            return false;
+        }
+        const std::string name = item.substr(0, eq);
+
+        // mode[:window[:k[:minSigma]]]
+        std::istringstream parts(item.substr(eq + 1));
+        std::string mode, tok;
+        std::getline(parts, mode, ':');
+
+        FieldConfig cfg;
+        if (mode == "off") cfg.mode = Mode::Off;
+        else if (mode == "median") cfg.mode = Mode::Median;
+        else if (mode == "hampel") cfg.mode = Mode::Hampel;
+        else {
+            if (error) *error = "unknown filter mode '" + mode + "'";
+            return false;
+        }
+        if (std::getline(parts, tok, ':')) cfg.window = std::atoi(tok.c_str());
+        if (std::getline(parts, tok, ':')) cfg.k = std::atof(tok.c_str());
+        if (std::getline(parts, tok, ':')) cfg.minSigma = std::atof(tok.c_str());
+        if (cfg.window < 1 || cfg.window > RunningMedian::kMaxWindow) {
+            if (error) *error = "window out of range in '" + item + "'";
+            return false;
+        }
+
+        int first = -1, last = -1;
+        if (name == "accel")      { first = F_AX; last = F_AZ; }
+        else if (name == "gyro")  { first = F_GX; last = F_GZ; }
+        else if (name == "mag")   { first = F_MX; last = F_MZ; }
+        else if (name == "baro")  { first = F_P;  last = F_T; }
+        else if (name == "all")   { first = 0;    last = kFieldCount - 1; }
+        else {
+            for (int f = 0; f < kFieldCount; ++f)
+                if (name == kFieldNames[f]) first = last = f;
+        }
+        if (first < 0) {
+            if (error) *error = "unknown field '" + name + "'";
+            return false;
+        }
+        for (int f = first; f <= last; ++f) setField(f, cfg);
+        if (name == "baro") setField(F_ALT, cfg);
+    }
+    return true;
+}
+
+void SampleFilter::apply(HudSample& s)
+{
+    for (int i = 0; i < kFieldCount; ++i) {
+        Field& f = m_fields[i];
+        if (f.cfg.mode == Mode::Off) continue;
+
+        double& v = s.*kFieldPtr[i];
+        if (!f.circular) {
+            v = f.filter.filter(v);
+            continue;
+        }
+
+        // Follow the angle continuously, filter that, then wrap back
+        const double P = f.wrapPeriod;
+        if (!f.haveRef) {
+            f.unwrapped = v;
+            f.haveRef = true;
+        } else {
+            double d = std::fmod(v - f.unwrapped, P);
+            if (d > P / 2) d -= P;
+            if (d < -P / 2) d += P;
+            f.unwrapped += d;
+        }
+        const double out = f.filter.filter(f.unwrapped);
+
+        if (i == F_HEADING) {
+            v = std::fmod(out, P);
+            if (v < 0) v += P;
+        } else {
+            v = std::fmod(out + P / 2, P);
+            if (v < 0) v += P;
+            v -= P / 2;
+        }
+    }
+}
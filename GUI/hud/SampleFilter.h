@@ -0,0 +1,58 @@
+#pragma once
+#include <string>
+#include "HudSample.h"
+#include "RobustFilter.h"
+
+// Per-field robust filter stage for HudSample, applied to raw sensor values
+// before fusion so a single glitchy reading never reaches the tapes.
+//
+// Each numeric field can be off, a running median, or Hampel rejection.
+// Angle fields (heading, roll) are unwrapped before filtering so a 359->1
+// crossing is not mistaken for an outlier.
+//
+// configure() takes a comma-separated spec:
+//   name=mode[:window[:k[:minSigma]]]
+// name is a field (heading roll pitch alt vs ax ay az gx gy gz mx my mz p T),
+// a group (accel gyro mag baro all), or "none" to turn everything off.
+// e.g.  "accel=hampel:9:3:0.3,alt=median:5,heading=off"
+
+class SampleFilter {
+public:
+    enum class Mode { Off, Median, Hampel };
+
+    struct FieldConfig {
+        Mode   mode = Mode::Off;
+        int    window = 7;
+        double k = 3.0;
+        double minSigma = 0.0;   // floor for the MAD-based sigma (field units)
+    };
+
+    static constexpr int kFieldCount = 16;
+    static const char* fieldName(int field);
+
+    SampleFilter();
+
+    void setField(int field, const FieldConfig& cfg);
+    const FieldConfig& field(int field) const { return m_fields[field].cfg; }
+
+    // Applies spec on top of the current config. Returns false (and leaves
+    // a message in error) if any entry can't be parsed.
+    bool configure(const std::string& spec, std::string* error = nullptr);
+
+    void apply(HudSample& s);
+    void reset();
+
+    unsigned long long rejected(int field) const { return m_fields[field].filter.rejected(); }
+
+private:
+    struct Field {
+        FieldConfig  cfg;
+        HampelFilter filter;
+        bool   circular = false;
+        double wrapPeriod = 360.0;
+        double unwrapped = 0.0;
+        bool   haveRef = false;
+    };
+
+    Field m_fields[kFieldCount];
+};
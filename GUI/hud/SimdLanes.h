@@ -0,0 +1,137 @@
+#pragma once
+
+// Minimal double-precision SIMD pack for the batch fusion kernels.
+//
+// Only IEEE correctly-rounded operations are exposed (+ - * / sqrt, compare,
+// select), so a kernel templated on DVec gives bit-identical results to the
+// same kernel instantiated with plain double -- provided the compiler isn't
+// allowed to contract a*b+c into FMA in one path and not the other
+// (the CMake targets build with -ffp-contract=off for that reason).
+
+#include <cmath>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+
+struct DVec {
+    static constexpr int N = 4;
+    __m256d v;
+
+    DVec() : v(_mm256_setzero_pd()) {}
+    DVec(double x) : v(_mm256_set1_pd(x)) {}
+    explicit DVec(__m256d x) : v(x) {}
+
+    static DVec load(const double* p) { return DVec(_mm256_loadu_pd(p)); }
+    void store(double* p) const { _mm256_storeu_pd(p, v); }
+};
+
+inline DVec operator+(DVec a, DVec b) { return DVec(_mm256_add_pd(a.v, b.v)); }
+inline DVec operator-(DVec a, DVec b) { return DVec(_mm256_sub_pd(a.v, b.v)); }
+inline DVec operator*(DVec a, DVec b) { return DVec(_mm256_mul_pd(a.v, b.v)); }
+inline DVec operator/(DVec a, DVec b) { return DVec(_mm256_div_pd(a.v, b.v)); }
+inline DVec operator-(DVec a) { return DVec(_mm256_xor_pd(a.v, _mm256_set1_pd(-0.0))); }
+inline DVec sqrt(DVec a) { return DVec(_mm256_sqrt_pd(a.v)); }
+inline DVec cmpGt(DVec a, DVec b) { return DVec(_mm256_cmp_pd(a.v, b.v, _CMP_GT_OQ)); }
+inline DVec operator&(DVec a, DVec b) { return DVec(_mm256_and_pd(a.v, b.v)); }
+inline DVec select(DVec mask, DVec a, DVec b) { return DVec(_mm256_blendv_pd(b.v, a.v, mask.v)); }
+
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+
+struct DVec {
+    static constexpr int N = 2;
+    __m128d v;
+
+    DVec() : v(_mm_setzero_pd()) {}
+    DVec(double x) : v(_mm_set1_pd(x)) {}
+    explicit DVec(__m128d x) : v(x) {}
+
+    static DVec load(const double* p) { return DVec(_mm_loadu_pd(p)); }
+    void store(double* p) const { _mm_storeu_pd(p, v); }
+};
+
+inline DVec operator+(DVec a, DVec b) { return DVec(_mm_add_pd(a.v, b.v)); }
+inline DVec operator-(DVec a, DVec b) { return DVec(_mm_sub_pd(a.v, b.v)); }
+inline DVec operator*(DVec a, DVec b) { return DVec(_mm_mul_pd(a.v, b.v)); }
+inline DVec operator/(DVec a, DVec b) { return DVec(_mm_div_pd(a.v, b.v)); }
+inline DVec operator-(DVec a) { return DVec(_mm_xor_pd(a.v, _mm_set1_pd(-0.0))); }
+inline DVec sqrt(DVec a) { return DVec(_mm_sqrt_pd(a.v)); }
+inline DVec cmpGt(DVec a, DVec b) { return DVec(_mm_cmpgt_pd(a.v, b.v)); }
+inline DVec operator&(DVec a, DVec b) { return DVec(_mm_and_pd(a.v, b.v)); }
+inline DVec select(DVec mask, DVec a, DVec b) {
+    return DVec(_mm_or_pd(_mm_and_pd(mask.v, a.v), _mm_andnot_pd(mask.v, b.v)));
+}
+
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+
+struct DVec {
+    static constexpr int N = 2;
+    float64x2_t v;
+
+    DVec() : v(vdupq_n_f64(0.0)) {}
+    DVec(double x) : v(vdupq_n_f64(x)) {}
+    explicit DVec(float64x2_t x) : v(x) {}
+
+    static DVec load(const double* p) { return DVec(vld1q_f64(p)); }
+    void store(double* p) const { vst1q_f64(p, v); }
+};
+
+inline DVec operator+(DVec a, DVec b) { return DVec(vaddq_f64(a.v, b.v)); }
+inline DVec operator-(DVec a, DVec b) { return DVec(vsubq_f64(a.v, b.v)); }
+inline DVec operator*(DVec a, DVec b) { return DVec(vmulq_f64(a.v, b.v)); }
+inline DVec operator/(DVec a, DVec b) { return DVec(vdivq_f64(a.v, b.v)); }
+inline DVec operator-(DVec a) { return DVec(vnegq_f64(a.v)); }
+inline DVec sqrt(DVec a) { return DVec(vsqrtq_f64(a.v)); }
+inline DVec cmpGt(DVec a, DVec b) {
+    return DVec(vreinterpretq_f64_u64(vcgtq_f64(a.v, b.v)));
+}
+inline DVec operator&(DVec a, DVec b) {
+    return DVec(vreinterpretq_f64_u64(vandq_u64(vreinterpretq_u64_f64(a.v),
+                                                vreinterpretq_u64_f64(b.v))));
+}
+inline DVec select(DVec mask, DVec a, DVec b) {
+    return DVec(vbslq_f64(vreinterpretq_u64_f64(mask.v), a.v, b.v));
+}
+
+#else
+
+// Portable fallback: same interface, plain loops.
+struct DVec {
+    static constexpr int N = 2;
+    double v[N];
+
+    DVec() : v{0.0, 0.0} {}
+    DVec(double x) : v{x, x} {}
+
+    static DVec load(const double* p) { DVec r; r.v[0] = p[0]; r.v[1] = p[1]; return r; }
+    void store(double* p) const { p[0] = v[0]; p[1] = v[1]; }
+};
+
+#define DVEC_BINOP(op) \
+    inline DVec operator op(DVec a, DVec b) { \
+        DVec r; for (int i = 0; i < DVec::N; ++i) r.v[i] = a.v[i] op b.v[i]; return r; }
+DVEC_BINOP(+)
+DVEC_BINOP(-)
+DVEC_BINOP(*)
+DVEC_BINOP(/)
+#undef DVEC_BINOP
+
+inline DVec operator-(DVec a) { DVec r; for (int i = 0; i < DVec::N; ++i) r.v[i] = -a.v[i]; return r; }
+inline DVec sqrt(DVec a) { DVec r; for (int i = 0; i < DVec::N; ++i) r.v[i] = std::sqrt(a.v[i]); return r; }
+// Masks are 1.0 / 0.0 in the fallback
+inline DVec cmpGt(DVec a, DVec b) {
+    DVec r; for (int i = 0; i < DVec::N; ++i) r.v[i] = a.v[i] > b.v[i] ? 1.0 : 0.0; return r;
+}
+inline DVec operator&(DVec a, DVec b) {
+    DVec r; for (int i = 0; i < DVec::N; ++i) r.v[i] = (a.v[i] != 0.0 && b.v[i] != 0.0) ? 1.0 : 0.0; return r;
+}
+inline DVec select(DVec m, DVec a, DVec b) {
+    DVec r; for (int i = 0; i < DVec::N; ++i) r.v[i] = m.v[i] != 0.0 ? a.v[i] : b.v[i]; return r;
+}
+
+#endif
+
+// Scalar overloads so kernels can be instantiated with plain double.
+inline bool   cmpGt(double a, double b) { return a > b; }
+inline double select(bool m, double a, double b) { return m ? a : b; }
@@ -0,0 +1,12 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+
+// Host time in µs on the steady clock (CLOCK_MONOTONIC on Linux, the clock
+// KMS flip timestamps use). Sample arrival, frame targets and flips are all
+// compared on it, so everything that stamps them reads it here.
+inline int64_t steadyNowUs()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
@@ -1,16 +1,21 @@
 #include "UartCborSource.h"
+#include "AttitudeMath.h"
+#include "SteadyClock.h"
 
 #include <QtCore/QCborValue>
 #include <QtCore/QCborMap>
 #include <QtCore/QCborArray>
 #include <QtCore/QCborParserError>
 
+#include <QDir>
+#include <QFileInfo>
 #include <QtMath>
 #include <cmath>
 
 UartCborSource::UartCborSource(QObject* parent) : QObject(parent) {
     connect(&m_serial, &QSerialPort::readyRead, this, &UartCborSource::onReadyRead);
     connect(&m_serial, &QSerialPort::errorOccurred, this, &UartCborSource::onError);
+    m_clock.start();
 }
 
 bool UartCborSource::start(const QString& portName, int baud) {
@@ -34,6 +39,35 @@ bool UartCborSource::start(const QString& portName, int baud) {
     m_expectedLen = 0;
     m_expectedCrc = 0;
     m_payload.clear();
+    m_filter.reset();
+    m_ahrs.reset();
+    m_alt.reset();
+    m_haveBaro = false;
+    return true;
+}
+
+bool UartCborSource::loadMagCalibration(const QString& path) {
+    MagCalibration cal;
+    if (!cal.load(path.toStdString())) return false;
+    m_magCal = cal;
+    emit logLine(QString("Mag calibration loaded: %1").arg(path));
+    return true;
+}
+
+void UartCborSource::startMagCalibration(const QString& savePath, int minSamples) {
+    m_magFit.reset();
+    m_magCalPath = savePath;
+    m_magCalMinSamples = minSamples;
+    m_magCalibrating = true;
+    emit logLine("Mag calibration: rotate the unit through all orientations");
+}
+
+bool UartCborSource::setFilterSpec(const QString& spec) {
+    std::string err;
+    if (!m_filter.configure(spec.toStdString(), &err)) {
+        emit logLine(QString("Bad filter spec: %1").arg(QString::fromStdString(err)));
+        return false;
+    }
     return true;
 }
 
@@ -63,9 +97,7 @@ quint32 UartCborSource::crc32_ieee(const uchar* data, int len) {
 }
 
 double UartCborSource::wrap360(double deg) {
-    deg = std::fmod(deg, 360.0);
-    if (deg < 0) deg += 360.0;
-    return deg;
+    return fastWrap360(deg);
 }
 
 void UartCborSource::onReadyRead() {
@@ -108,9 +140,13 @@ bool UartCborSource::tryParseTextLine() {
     }
 
     HudSample s;
-    if (parseDevLineToSample(line, s)) {
-        computeAttitudeFallback(s);
+    bool haveEuler = false;
+    if (parseDevLineToSample(line, s, haveEuler)) {
+        m_filter.apply(s);
+        computeAttitudeFallback(s, haveEuler);
+        fuseAltitude(s);
         m_textLines++;
+        s.hostUs = steadyNowUs();
         emit sampleReady(s);
     }
     return true;
@@ -174,16 +210,22 @@ bool UartCborSource::tryParseBinaryFrame() {
             }
 
             HudSample s;
-            if (!decodeCborToSample(m_payload, s)) {
+            bool haveEuler = false;
+            if (!decodeCborToSample(m_payload, s, haveEuler)) {
                 m_badCbor++;
                 m_state = State::FindSync;
                 continue;
             }
 
-            // if ESP32 hasn't populated euler yet, compute attitude from raw IMU here
-            computeAttitudeFallback(s);
+            // reject glitches in the raw fields before they reach the fusion
+            m_filter.apply(s);
+
+            // run the host AHRS on every frame; it only overrides euler the ESP32 didn't fill
+            computeAttitudeFallback(s, haveEuler);
+            fuseAltitude(s);
 
             m_ok++;
+            s.hostUs = steadyNowUs();
             emit sampleReady(s);
             m_state = State::FindSync;
             return true; // parsed one full binary frame
@@ -198,7 +240,7 @@ static bool mapGetDouble(const QCborMap& m, const char* key, double& out) {
     return false;
 }
 
-bool UartCborSource::decodeCborToSample(const QByteArray& payload, HudSample& out) {
+bool UartCborSource::decodeCborToSample(const QByteArray& payload, HudSample& out, bool& haveEuler) {
     QCborParserError err;
     QCborValue root = QCborValue::fromCbor(payload, &err);
     if (err.error != QCborError::NoError || !root.isMap()) {
@@ -210,7 +252,10 @@ bool UartCborSource::decodeCborToSample(const QByteArray& payload, HudSample& ou
 
     // ts_us -> tsMs
     double ts_us = 0;
-    if (mapGetDouble(m, "ts_us", ts_us)) out.tsMs = (long long)(ts_us / 1000.0);
+    if (mapGetDouble(m, "ts_us", ts_us)) {
+        out.tsUs = (long long)ts_us;
+        out.tsMs = (long long)(ts_us / 1000.0);
+    }
 
     // baro/alt/vs
     double alt_m = 0, vs_mps = 0;
@@ -266,14 +311,21 @@ bool UartCborSource::decodeCborToSample(const QByteArray& payload, HudSample& ou
             out.rollDeg  = roll  * (180.0 / M_PI);
             out.pitchDeg = pitch * (180.0 / M_PI);
             out.headingDeg = wrap360(yaw * (180.0 / M_PI));
+
+            // all-zero means the ESP32 is sending a placeholder
+            haveEuler = (roll != 0.0 || pitch != 0.0 || yaw != 0.0);
         }
     }
 
     return true;
 }
 
+// key must start a token (line start or after whitespace), so "Y=" does
+// not match inside "AY=" / "GY=" / "MY="
 static bool extractNumberAfter(const QByteArray& line, const QByteArray& key, double& out) {
     int idx = line.indexOf(key);
+    while (idx > 0 && line[idx - 1] != ' ' && line[idx - 1] != '\t')
+        idx = line.indexOf(key, idx + 1);
     if (idx < 0) return false;
     idx += key.size();
 
@@ -294,7 +346,7 @@ static bool extractNumberAfter(const QByteArray& line, const QByteArray& key, do
     return ok;
 }
 
-bool UartCborSource::parseDevLineToSample(const QByteArray& line, HudSample& out) {
+bool UartCborSource::parseDevLineToSample(const QByteArray& line, HudSample& out, bool& haveEuler) {
     // Example:
     // p=1015.476 hPa  T=23.19 C  alt=-18.51 m  vs=-0.05 m/s  AX=-0.056 AY=-0.130 AZ=9.772  GX=0.038 ...
 
@@ -323,20 +375,35 @@ bool UartCborSource::parseDevLineToSample(const QByteArray& line, HudSample& out
     extractNumberAfter(line, "MY=", out.my);
     extractNumberAfter(line, "MZ=", out.mz);
 
-    extractNumberAfter(line, "R=", out.rollDeg);
-    extractNumberAfter(line, "P=", out.pitchDeg);
-    extractNumberAfter(line, "Y=", out.headingDeg);
+    // Only firmware that computes its own attitude sends R= / P= / Y=;
+    // without them the host filter supplies it
+    const bool gotR = extractNumberAfter(line, "R=", out.rollDeg);
+    const bool gotP = extractNumberAfter(line, "P=", out.pitchDeg);
+    const bool gotY = extractNumberAfter(line, "Y=", out.headingDeg);
+    haveEuler = gotR || gotP || gotY;
 
     out.tsMs = 0; // DEV line doesn't carry time; ok for now
     return true;
 }
 
 // --- attitude fallback ---
-// This gives you R/P from accelerometer and heading from tilt-comp mag.
-// Good enough for demo; later you should do proper fusion on ESP32.
-void UartCborSource::computeAttitudeFallback(HudSample& s) {
-    // If ESP32 already provided non-zero euler, keep it.
-    if (std::fabs(s.rollDeg) > 0.01 || std::fabs(s.pitchDeg) > 0.01 || std::fabs(s.headingDeg) > 0.01) {
+// Roll/pitch from the host Madgwick filter (gyro integrated, accel-corrected),
+// heading from the tilt-compensated magnetometer using that roll/pitch.
+// The filter is stepped on every sample so it stays converged even while the
+// ESP32 is supplying its own euler angles.
+long long UartCborSource::sampleTimeUs(const HudSample& s) const {
+    // DEV text lines carry no device time; arrival time is the best we have.
+    return s.tsUs ? s.tsUs : m_clock.nsecsElapsed() / 1000;
+}
+
+void UartCborSource::computeAttitudeFallback(HudSample& s, bool haveEuler) {
+    m_ahrs.updateAt(sampleTimeUs(s), s.gx, s.gy, s.gz, s.ax, s.ay, s.az);
+
+    // Calibration sees raw readings; everything downstream sees corrected ones
+    if (m_magCalibrating) accumulateMagCalibration(s);
+    if (m_magCal.valid) m_magCal.apply(s.mx, s.my, s.mz);
+
+    if (haveEuler || !m_ahrs.isInitialized()) {
         return;
     }
 
@@ -346,42 +413,83 @@ void UartCborSource::computeAttitudeFallback(HudSample& s) {
     //  ay = +right
     //  az = +up
     // If your az is "down", you'll flip signs.
-    const double ax = s.ax;
-    const double ay = s.ay;
-    const double az = s.az;
-
-    // Roll/Pitch from accel (radians)
-    const double roll  = std::atan2(ay, az);
-    const double pitch = std::atan2(-ax, std::sqrt(ay*ay + az*az));
+    const double roll  = m_ahrs.rollRad();
+    const double pitch = m_ahrs.pitchRad();
 
     s.rollDeg  = roll * (180.0 / M_PI);
     s.pitchDeg = pitch * (180.0 / M_PI);
 
-    // Tilt-compensated heading from magnetometer
-    // Normalize mag is optional; we just use ratios.
-    const double mx = s.my;
-    const double my = s.mx;
-    const double mz = -s.mz;
+    // Tilt-compensated heading from magnetometer (declination configurable;
+    // default is Orlando)
+    s.headingDeg = tiltCompensatedHeadingDeg(roll, pitch, s.mx, s.my, s.mz, m_declinationDeg);
+}
 
-    const double cr = std::cos(roll),  sr = std::sin(roll);
-    const double cp = std::cos(pitch), sp = std::sin(pitch);
+// --- altitude / vertical speed ---
+// The ESP32 sends baro altitude on every frame but only refreshes it at the
+// baro rate, so a reading is treated as new only when it changes. Between
+// readings the Kalman filter is propagated with earth-frame vertical accel
+// from the AHRS, which gives vspeed at the IMU rate with little lag.
+void UartCborSource::fuseAltitude(HudSample& s) {
+    static constexpr double G = 9.80665;   // accel is in m/s^2
+
+    double accelUp = 0.0;
+    if (m_ahrs.isInitialized() && (s.ax != 0.0 || s.ay != 0.0 || s.az != 0.0)) {
+        accelUp = m_ahrs.upComponent(s.ax, s.ay, s.az) - G;
+    }
 
-    const double Xh = mx*cp + mz*sp;
-    const double Yh = mx*sr*sp + my*cr - mz*sr*cp;
+    const bool newBaro = !m_haveBaro || !m_alt.isInitialized() || s.altitudeFt != m_lastBaroAltFt;
+    m_lastBaroAltFt = s.altitudeFt;
+    m_haveBaro = true;
 
-    double heading = std::atan2(Yh, Xh) * 180.0 / M_PI;
+    m_alt.update(sampleTimeUs(s), accelUp, newBaro, s.altitudeFt / 3.280839895);
+    if (!m_alt.isInitialized()) return;
 
-    if (heading < 0)
-        heading += 360.0;
+    s.altitudeFt = m_alt.altitudeM() * 3.280839895;
+    s.vspeedFpm  = m_alt.vspeedMps() * 196.8503937007874;
+}
 
-    // Orlando magnetic declination
-    heading -= 6.3;
+// --- magnetometer calibration ---
+// Streams raw mag readings into the ellipsoid accumulator; once enough have
+// been seen and the fit is a proper ellipsoid, the result is saved (so the
+// next start picks it up) and applied immediately.
+void UartCborSource::accumulateMagCalibration(const HudSample& s) {
+    if (s.mx == 0.0 && s.my == 0.0 && s.mz == 0.0) return;   // no mag in this frame
+
+    m_magFit.add(s.mx, s.my, s.mz);
+    const long long n = m_magFit.count();
+    if (n < m_magCalMinSamples) {
+        if (n % 500 == 0) {
+            emit logLine(QString("Mag calibration: %1/%2 samples, span x=%3 y=%4 z=%5")
+                         .arg(n).arg(m_magCalMinSamples)
+                         .arg(m_magFit.span(0), 0, 'f', 1)
+                         .arg(m_magFit.span(1), 0, 'f', 1)
+                         .arg(m_magFit.span(2), 0, 'f', 1));
+        }
+        return;
+    }
 
-    if (heading < 0) heading += 360.0;
-    if (heading >= 360) heading -= 360.0;
+    // Past the minimum, retry every 500 samples until the fit holds
+    if ((n - m_magCalMinSamples) % 500 != 0) return;
 
-    // If it appears mirrored, flip sign:
-    // heading = -heading;
+    MagCalibration cal;
+    double rms = 0;
+    if (!m_magFit.fit(cal, &rms)) {
+        emit logLine("Mag calibration: fit not an ellipsoid yet; keep rotating");
+        return;
+    }
 
-    s.headingDeg = wrap360(heading);
-}
\ No newline at end of file
+    m_magCal = cal;
+    m_magCalibrating = false;
+
+    QDir().mkpath(QFileInfo(m_magCalPath).absolutePath());
+    if (cal.save(m_magCalPath.toStdString())) {
+        emit logLine(QString("Mag calibration saved to %1 (offset %2 %3 %4, residual %5)")
+                     .arg(m_magCalPath)
+                     .arg(cal.offset[0], 0, 'f', 2)
+                     .arg(cal.offset[1], 0, 'f', 2)
+                     .arg(cal.offset[2], 0, 'f', 2)
+                     .arg(rms, 0, 'g', 3));
+    } else {
+        emit logLine(QString("Mag calibration: could not write %1").arg(m_magCalPath));
+    }
+}
@@ -2,7 +2,12 @@
 #include <QObject>
 #include <QByteArray>
 #include <QSerialPort>
+#include <QElapsedTimer>
 #include "HudSample.h"
+#include "AhrsFilter.h"
+#include "AltitudeFilter.h"
+#include "MagCalibration.h"
+#include "SampleFilter.h"
 
 // Reads ESP32 output in either mode:
 // 1) DEV_MODE=0 binary frames: [AA][55][len u32 BE][CBOR][crc32 u32 BE]
@@ -17,6 +22,25 @@ public:
     void stop();
     bool isOpen() const { return m_serial.isOpen(); }
 
+    // Gain of the host-side AHRS used when the ESP32 doesn't send euler angles.
+    void setAhrsBeta(double beta) { m_ahrs.setBeta(beta); }
+
+    // Magnetometer: hard/soft-iron correction and declination for heading.
+    bool loadMagCalibration(const QString& path);
+    void startMagCalibration(const QString& savePath, int minSamples = 3000);
+    bool isMagCalibrating() const { return m_magCalibrating; }
+    void setDeclinationDeg(double deg) { m_declinationDeg = deg; }
+
+    // Outlier/median filtering of raw fields, see SampleFilter for the syntax.
+    bool setFilterSpec(const QString& spec);
+    const SampleFilter& sampleFilter() const { return m_filter; }
+
+    // Frame counters since start (binary mode; text lines counted apart)
+    struct LinkStats {
+        quint64 ok = 0, badCrc = 0, badLen = 0, badCbor = 0, textLines = 0;
+    };
+    LinkStats linkStats() const { return LinkStats{ m_ok, m_badCrc, m_badLen, m_badCbor, m_textLines }; }
+
 signals:
     void sampleReady(const HudSample& s);
     void logLine(const QString& s);
@@ -39,14 +63,37 @@ private:
     // --- Stats (optional) ---
     quint64 m_ok=0, m_badCrc=0, m_badLen=0, m_badCbor=0, m_textLines=0;
 
+    // --- Raw field filtering (before fusion) ---
+    SampleFilter   m_filter;
+
+    // --- Host-side attitude ---
+    AhrsFilter     m_ahrs;
+    AltitudeFilter m_alt;
+    double         m_lastBaroAltFt = 0;
+    bool           m_haveBaro = false;
+    QElapsedTimer  m_clock;   // stands in for device time on DEV text lines
+
+    // --- Magnetometer ---
+    MagCalibration m_magCal;
+    MagCalibrator  m_magFit;
+    bool           m_magCalibrating = false;
+    int            m_magCalMinSamples = 3000;
+    QString        m_magCalPath;
+    double         m_declinationDeg = -6.3;   // Orlando
+
     // helpers
     bool tryParseBinaryFrame();      // returns true if it consumed a full frame
     bool tryParseTextLine();         // returns true if it consumed one full line
-    bool decodeCborToSample(const QByteArray& payload, HudSample& out);
-    bool parseDevLineToSample(const QByteArray& line, HudSample& out);
+    bool decodeCborToSample(const QByteArray& payload, HudSample& out, bool& haveEuler);
+    bool parseDevLineToSample(const QByteArray& line, HudSample& out, bool& haveEuler);
+
+    // host AHRS; its output is used unless the ESP sent real euler angles
+    void computeAttitudeFallback(HudSample& s, bool haveEuler);
 
-    // math fallback if ESP sends euler zeros
-    void computeAttitudeFallback(HudSample& s);
+    // baro + vertical accel -> smoothed altitude / vspeed (replaces device "vs")
+    void fuseAltitude(HudSample& s);
+    void accumulateMagCalibration(const HudSample& s);
+    long long sampleTimeUs(const HudSample& s) const;
 
     static quint32 readU32BE(const uchar* p);
     static quint32 crc32_ieee(const uchar* data, int len);
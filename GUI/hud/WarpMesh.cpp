@@ -0,0 +1,197 @@
+#include "WarpMesh.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+// ---------------------------------------------------------------------------
+// WarpParams
+
+// Unit square -> quad (Heckbert), as a row-major 3x3 with h[8] = 1
+static void squareToQuad(const double* qx, const double* qy, double h[9])
+{
+    const double dx1 = qx[1] - qx[2], dx2 = qx[3] - qx[2];
+    const double dy1 = qy[1] - qy[2], dy2 = qy[3] - qy[2];
+    const double sx = qx[0] - qx[1] + qx[2] - qx[3];
+    const double sy = qy[0] - qy[1] + qy[2] - qy[3];
+    const double den = dx1 * dy2 - dx2 * dy1;
+    const double g = (den != 0.0) ? (sx * dy2 - dx2 * sy) / den : 0.0;
+    const double k = (den != 0.0) ? (dx1 * sy - sx * dy1) / den : 0.0;
+
+    h[0] = qx[1] - qx[0] + g * qx[1];  h[1] = qx[3] - qx[0] + k * qx[3];  h[2] = qx[0];
+    h[3] = qy[1] - qy[0] + g * qy[1];  h[4] = qy[3] - qy[0] + k * qy[3];  h[5] = qy[0];
+    h[6] = g;                          h[7] = k;                          h[8] = 1.0;
+}
+
+static bool invert3(const double m[9], double r[9])
+{
+    const double c0 = m[4] * m[8] - m[5] * m[7];
+    const double c1 = m[5] * m[6] - m[3] * m[8];
+    const double c2 = m[3] * m[7] - m[4] * m[6];
+    const double det = m[0] * c0 + m[1] * c1 + m[2] * c2;
+    if (std::fabs(det) < 1e-12) return false;
+    const double inv = 1.0 / det;
+    r[0] = c0 * inv;  r[1] = (m[2] * m[7] - m[1] * m[8]) * inv;  r[2] = (m[1] * m[5] - m[2] * m[4]) * inv;
+    r[3] = c1 * inv;  r[4] = (m[0] * m[8] - m[2] * m[6]) * inv;  r[5] = (m[2] * m[3] - m[0] * m[5]) * inv;
+    r[6] = c2 * inv;  r[7] = (m[1] * m[6] - m[0] * m[7]) * inv;  r[8] = (m[0] * m[4] - m[1] * m[3]) * inv;
+    return true;
+}
+
+static void applyH(const double h[9], double x, double y, double& ox, double& oy)
+{
+    const double w = h[6] * x + h[7] * y + h[8];
+    ox = (h[0] * x + h[1] * y + h[2]) / w;
+    oy = (h[3] * x + h[4] * y + h[5]) / w;
+}
+
+// Squared radius around the output center, 1 at the corners
+static double radius2(const WarpParams& p, double x, double y)
+{
+    const double dx = (x - 0.5) * p.aspect, dy = y - 0.5;
+    return (dx * dx + dy * dy) / (0.25 * p.aspect * p.aspect + 0.25);
+}
+
+bool WarpParams::isIdentity() const
+{
+    static const double ix[4] = {0, 1, 1, 0}, iy[4] = {0, 0, 1, 1};
+    for (int i = 0; i < 4; ++i)
+        if (cornerX[i] != ix[i] || cornerY[i] != iy[i]) return false;
+    return k1 == 0.0;
+}
+
+void WarpParams::forward(double u, double v, double& x, double& y) const
+{
+    double h[9];
+    squareToQuad(cornerX, cornerY, h);
+    double px, py;
+    applyH(h, u, v, px, py);
+
+    const double s = 1.0 + k1 * radius2(*this, px, py);
+    x = 0.5 + (px - 0.5) * s;
+    y = 0.5 + (py - 0.5) * s;
+}
+
+bool WarpParams::inverse(double x, double y, double& u, double& v) const
+{
+    // Undo the radial term: p = c + (o - c) / (1 + k1 r(p)^2), by fixed-point
+    // iteration (contracts for the |k1| a combiner needs)
+    double px = x, py = y;
+    for (int it = 0; it < 30; ++it) {
+        const double s = 1.0 + k1 * radius2(*this, px, py);
+        if (s <= 0.05) return false;
+        px = 0.5 + (x - 0.5) / s;
+        py = 0.5 + (y - 0.5) / s;
+    }
+
+    double h[9], hi[9];
+    squareToQuad(cornerX, cornerY, h);
+    if (!invert3(h, hi)) return false;
+    applyH(hi, px, py, u, v);
+    return std::isfinite(u) && std::isfinite(v);
+}
+
+// ---------------------------------------------------------------------------
+// WarpMesh
+
+WarpMesh WarpMesh::identity(int cols, int rows)
+{
+    return fromParams(WarpParams(), cols, rows);
+}
+
+WarpMesh WarpMesh::fromParams(const WarpParams& p, int cols, int rows)
+{
+    WarpMesh m;
+    m.m_cols = std::max(2, cols);
+    m.m_rows = std::max(2, rows);
+    m.m_u.resize(size_t(m.m_cols) * m.m_rows);
+    m.m_v.resize(m.m_u.size());
+    for (int j = 0; j < m.m_rows; ++j) {
+        for (int i = 0; i < m.m_cols; ++i) {
+            double u, v;
+            // Off-source is fine (samples black); a singular point is not
+            if (!p.inverse(double(i) / (m.m_cols - 1), double(j) / (m.m_rows - 1), u, v)) u = v = -1.0;
+            m.m_u[size_t(j) * m.m_cols + i] = u;
+            m.m_v[size_t(j) * m.m_cols + i] = v;
+        }
+    }
+    m.m_params = p;
+    m.m_hasParams = true;
+    return m;
+}
+
+void WarpMesh::map(double x, double y, double& u, double& v) const
+{
+    const double gx = std::min(std::max(x, 0.0), 1.0) * (m_cols - 1);
+    const double gy = std::min(std::max(y, 0.0), 1.0) * (m_rows - 1);
+    const int i = std::min(int(gx), m_cols - 2);
+    const int j = std::min(int(gy), m_rows - 2);
+    const double fx = gx - i, fy = gy - j;
+
+    const size_t a = size_t(j) * m_cols + i, c = a + m_cols;
+    u = (m_u[a] * (1 - fx) + m_u[a + 1] * fx) * (1 - fy) + (m_u[c] * (1 - fx) + m_u[c + 1] * fx) * fy;
+    v = (m_v[a] * (1 - fx) + m_v[a + 1] * fx) * (1 - fy) + (m_v[c] * (1 - fx) + m_v[c + 1] * fx) * fy;
+}
+
+bool WarpMesh::load(const std::string& path)
+{
+    std::ifstream in(path);
+    if (!in) return false;
+
+    WarpMesh m;
+    int row = 0;
+    std::string line;
+    while (std::getline(in, line)) {
+        std::istringstream ls(line);
+        std::string key;
+        if (!(ls >> key) || key[0] == '#') continue;
+
+        if (key == "params") {
+            WarpParams& p = m.m_params;
+            m.m_hasParams = bool(ls >> p.aspect >> p.k1);
+            for (int i = 0; i < 4; ++i)
+                if (!(ls >> p.cornerX[i] >> p.cornerY[i])) m.m_hasParams = false;
+        } else if (key == "mesh") {
+            if (!(ls >> m.m_cols >> m.m_rows) || m.m_cols < 2 || m.m_rows < 2 ||
+                m.m_cols > 1024 || m.m_rows > 1024)
+                return false;
+            m.m_u.assign(size_t(m.m_cols) * m.m_rows, 0.0);
+            m.m_v.assign(m.m_u.size(), 0.0);
+        } else if (key == "row") {
+            if (!m.isValid() || row >= m.m_rows) return false;
+            for (int i = 0; i < m.m_cols; ++i) {
+                const size_t k = size_t(row) * m.m_cols + i;
+                if (!(ls >> m.m_u[k] >> m.m_v[k])) return false;
+            }
+            ++row;
+        }
+    }
+    if (!m.isValid() || row != m.m_rows) return false;
+
+    *this = m;
+    return true;
+}
+
+bool WarpMesh::save(const std::string& path) const
+{
+    std::ofstream out(path);
+    if (!out) return false;
+
+    out.precision(9);
+    out << "# PEGASUS projector warp: output point -> source point, normalized 0..1\n";
+    if (m_hasParams) {
+        out << "params " << m_params.aspect << ' ' << m_params.k1;
+        for (int i = 0; i < 4; ++i) out << ' ' << m_params.cornerX[i] << ' ' << m_params.cornerY[i];
+        out << '\n';
+    }
+    out << "mesh " << m_cols << ' ' << m_rows << '\n';
+    for (int j = 0; j < m_rows; ++j) {
+        out << "row";
+        for (int i = 0; i < m_cols; ++i) {
+            const size_t k = size_t(j) * m_cols + i;
+            out << ' ' << m_u[k] << ' ' << m_v[k];
+        }
+        out << '\n';
+    }
+    return bool(out);
+}
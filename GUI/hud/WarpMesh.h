@@ -0,0 +1,60 @@
+#pragma once
+#include <string>
+#include <vector>
+
+// Projector / combiner geometry correction.
+//
+// WarpParams describe the distortion the HUD must pre-apply: where the
+// corners of the rendered frame should land on the output (keystone, as a
+// homography of the unit square) followed by a radial term around the
+// output center (k1 > 0 pushes points outward = pincushion pre-warp to
+// cancel barrel, k1 < 0 the reverse). All coordinates are normalized 0..1
+// over the output; r is 1 at the corners.
+//
+// WarpMesh samples the inverse (output point -> source point) on a regular
+// grid, which is what a remap needs. grid_test edits the params and saves
+// both; the HUD only needs the mesh, so hand-tuned nodes also work.
+struct WarpParams {
+    double cornerX[4] = {0, 1, 1, 0};   // TL, TR, BR, BL
+    double cornerY[4] = {0, 0, 1, 1};
+    double k1 = 0.0;
+    double aspect = 16.0 / 9.0;         // output width / height, for r
+
+    bool isIdentity() const;
+
+    // Source -> output (what the viewer sees) and its inverse
+    void forward(double u, double v, double& x, double& y) const;
+    bool inverse(double x, double y, double& u, double& v) const;
+};
+
+class WarpMesh {
+public:
+    static constexpr int kDefaultCols = 33;
+    static constexpr int kDefaultRows = 19;
+
+    static WarpMesh identity(int cols = kDefaultCols, int rows = kDefaultRows);
+    static WarpMesh fromParams(const WarpParams& p, int cols = kDefaultCols, int rows = kDefaultRows);
+
+    int cols() const { return m_cols; }
+    int rows() const { return m_rows; }
+    bool isValid() const { return m_cols >= 2 && m_rows >= 2; }
+
+    // Normalized source point for normalized output point (bilinear between
+    // nodes, clamped to the mesh)
+    void map(double x, double y, double& u, double& v) const;
+
+    // Params the mesh was made from, if any (for re-editing in grid_test)
+    const WarpParams& params() const { return m_params; }
+    bool hasParams() const { return m_hasParams; }
+
+    // Plain text: "params ...", "mesh cols rows", then one "row" line of
+    // u v pairs per mesh row. Returns false on error.
+    bool load(const std::string& path);
+    bool save(const std::string& path) const;
+
+private:
+    int m_cols = 0, m_rows = 0;
+    std::vector<double> m_u, m_v;   // row-major, node (i, j) at output (i/(cols-1), j/(rows-1))
+    WarpParams m_params;
+    bool m_hasParams = false;
+};
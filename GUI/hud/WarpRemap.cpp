@@ -0,0 +1,296 @@
+#include "WarpRemap.h"
+#include "WarpMesh.h"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define WARP_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define WARP_NEON 1
+#endif
+
+static constexpr uint32_t kOutside = 0xff000000u;
+static_assert(WarpRemap::kTile == 16, "apply() steps tiles with >> 4");
+
+// Bilinear weights for 4-bit fractions; they sum to 256
+struct Weights {
+    uint32_t w00, w01, w10, w11;
+    Weights(uint32_t fx, uint32_t fy)
+        : w00((16 - fx) * (16 - fy)), w01(fx * (16 - fy)), w10((16 - fx) * fy), w11(fx * fy) {}
+};
+
+// Two channels per 32-bit word; each 16-bit lane sums to <= 255 * 256
+static inline uint32_t blend(uint32_t a, uint32_t b, uint32_t c, uint32_t d, uint32_t fx, uint32_t fy)
+{
+    const Weights w(fx, fy);
+    const uint32_t rb = (a & 0x00ff00ffu) * w.w00 + (b & 0x00ff00ffu) * w.w01 +
+                        (c & 0x00ff00ffu) * w.w10 + (d & 0x00ff00ffu) * w.w11;
+    const uint32_t ag = ((a >> 8) & 0x00ff00ffu) * w.w00 + ((b >> 8) & 0x00ff00ffu) * w.w01 +
+                        ((c >> 8) & 0x00ff00ffu) * w.w10 + ((d >> 8) & 0x00ff00ffu) * w.w11;
+    return ((rb >> 8) & 0x00ff00ffu) | (ag & 0xff00ff00u);
+}
+
+static inline uint32_t sample(const uint32_t* src, int stride, int w1, int h1, int32_t u, int32_t v)
+{
+    const int ix = u >> 16, iy = v >> 16;
+    const uint32_t fx = (u >> 12) & 15, fy = (v >> 12) & 15;
+    if (unsigned(ix) < unsigned(w1) && unsigned(iy) < unsigned(h1)) {
+        const uint32_t* p = src + ptrdiff_t(iy) * stride + ix;
+        return blend(p[0], p[1], p[stride], p[stride + 1], fx, fy);
+    }
+
+    // Between the outer pixel centres and the image edge (half a pixel)
+    // the missing neighbours repeat the edge pixel
+    const int32_t half = 1 << 15;
+    if (u < -half || u >= (int32_t(w1) << 16) + half || v < -half || v >= (int32_t(h1) << 16) + half)
+        return kOutside;
+    const int x0 = std::max(ix, 0), x1 = std::min(ix + 1, w1);
+    const int y0 = std::max(iy, 0), y1 = std::min(iy + 1, h1);
+    const uint32_t* r0 = src + ptrdiff_t(y0) * stride;
+    const uint32_t* r1 = src + ptrdiff_t(y1) * stride;
+    return blend(r0[x0], r0[x1], r1[x0], r1[x1], fx, fy);
+}
+
+static void rowPortable(const uint32_t* src, int stride, int w1, int h1,
+                        uint32_t* dst, int n, int32_t u, int32_t v, int32_t du, int32_t dv)
+{
+    for (int i = 0; i < n; ++i, u += du, v += dv)
+        dst[i] = sample(src, stride, w1, h1, u, v);
+}
+
+#if defined(WARP_SSE2) || defined(WARP_NEON)
+
+// 16-bit lane weights per (fx, fy): top = [w00 x4, w01 x4], bottom = [w10 x4, w11 x4]
+struct alignas(16) WeightTable {
+    uint16_t top[256][8];
+    uint16_t bot[256][8];
+
+    WeightTable()
+    {
+        for (uint32_t fx = 0; fx < 16; ++fx) {
+            for (uint32_t fy = 0; fy < 16; ++fy) {
+                const Weights w(fx, fy);
+                const int k = int(fx * 16 + fy);
+                for (int c = 0; c < 4; ++c) {
+                    top[k][c] = uint16_t(w.w00);  top[k][c + 4] = uint16_t(w.w01);
+                    bot[k][c] = uint16_t(w.w10);  bot[k][c + 4] = uint16_t(w.w11);
+                }
+            }
+        }
+    }
+};
+
+static const WeightTable& weightTable()
+{
+    static const WeightTable t;
+    return t;
+}
+
+static inline int weightIndex(int32_t u, int32_t v)
+{
+    return int(((u >> 8) & 0xf0) | ((v >> 12) & 15));
+}
+
+#endif
+
+#if defined(WARP_SSE2)
+
+// Per-pixel partial sums: [p00*w00 + p10*w10 | p01*w01 + p11*w11]
+static inline __m128i gather(const uint32_t* p, int stride, const WeightTable& t, int k)
+{
+    const __m128i z = _mm_setzero_si128();
+    const __m128i top = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p)), z);
+    const __m128i bot = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p + stride)), z);
+    return _mm_add_epi16(_mm_mullo_epi16(top, _mm_load_si128(reinterpret_cast<const __m128i*>(t.top[k]))),
+                         _mm_mullo_epi16(bot, _mm_load_si128(reinterpret_cast<const __m128i*>(t.bot[k]))));
+}
+
+static void rowSimd(const uint32_t* src, int stride, int w1, int h1,
+                    uint32_t* dst, int n, int32_t u, int32_t v, int32_t du, int32_t dv)
+{
+    const WeightTable& t = weightTable();
+    int i = 0;
+    for (; i + 2 <= n; i += 2, u += 2 * du, v += 2 * dv) {
+        const int32_t u1 = u + du, v1 = v + dv;
+        const int ax = u >> 16, ay = v >> 16, bx = u1 >> 16, by = v1 >> 16;
+        if (unsigned(ax) >= unsigned(w1) || unsigned(ay) >= unsigned(h1) ||
+            unsigned(bx) >= unsigned(w1) || unsigned(by) >= unsigned(h1)) {
+            dst[i]     = sample(src, stride, w1, h1, u, v);
+            dst[i + 1] = sample(src, stride, w1, h1, u1, v1);
+            continue;
+        }
+        const __m128i a = gather(src + ptrdiff_t(ay) * stride + ax, stride, t, weightIndex(u, v));
+        const __m128i b = gather(src + ptrdiff_t(by) * stride + bx, stride, t, weightIndex(u1, v1));
+        const __m128i sum = _mm_add_epi16(_mm_unpacklo_epi64(a, b), _mm_unpackhi_epi64(a, b));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + i),
+                         _mm_packus_epi16(_mm_srli_epi16(sum, 8), _mm_setzero_si128()));
+    }
+    if (i < n) dst[i] = sample(src, stride, w1, h1, u, v);
+}
+
+#elif defined(WARP_NEON)
+
+static inline uint16x4_t gather(const uint32_t* p, int stride, const WeightTable& t, int k)
+{
+    const uint16x8_t top = vmovl_u8(vld1_u8(reinterpret_cast<const uint8_t*>(p)));
+    const uint16x8_t bot = vmovl_u8(vld1_u8(reinterpret_cast<const uint8_t*>(p + stride)));
+    const uint16x8_t s = vmlaq_u16(vmulq_u16(top, vld1q_u16(t.top[k])), bot, vld1q_u16(t.bot[k]));
+    return vadd_u16(vget_low_u16(s), vget_high_u16(s));
+}
+
+static void rowSimd(const uint32_t* src, int stride, int w1, int h1,
+                    uint32_t* dst, int n, int32_t u, int32_t v, int32_t du, int32_t dv)
+{
+    const WeightTable& t = weightTable();
+    int i = 0;
+    for (; i + 2 <= n; i += 2, u += 2 * du, v += 2 * dv) {
+        const int32_t u1 = u + du, v1 = v + dv;
+        const int ax = u >> 16, ay = v >> 16, bx = u1 >> 16, by = v1 >> 16;
+        if (unsigned(ax) >= unsigned(w1) || unsigned(ay) >= unsigned(h1) ||
+            unsigned(bx) >= unsigned(w1) || unsigned(by) >= unsigned(h1)) {
+            dst[i]     = sample(src, stride, w1, h1, u, v);
+            dst[i + 1] = sample(src, stride, w1, h1, u1, v1);
+            continue;
+        }
+        const uint16x4_t a = gather(src + ptrdiff_t(ay) * stride + ax, stride, t, weightIndex(u, v));
+        const uint16x4_t b = gather(src + ptrdiff_t(by) * stride + bx, stride, t, weightIndex(u1, v1));
+        vst1_u8(reinterpret_cast<uint8_t*>(dst + i), vshrn_n_u16(vcombine_u16(a, b), 8));
+    }
+    if (i < n) dst[i] = sample(src, stride, w1, h1, u, v);
+}
+
+#else
+
+static void rowSimd(const uint32_t* src, int stride, int w1, int h1,
+                    uint32_t* dst, int n, int32_t u, int32_t v, int32_t du, int32_t dv)
+{
+    rowPortable(src, stride, w1, h1, dst, n, u, v, du, dv);
+}
+
+#endif
+
+void WarpRemap::clear()
+{
+    *this = WarpRemap();
+}
+
+void WarpRemap::build(const WarpMesh& mesh, int outW, int outH, int srcW, int srcH)
+{
+    clear();
+    if (!mesh.isValid() || outW <= 0 || outH <= 0 || srcW < 2 || srcH < 2) return;
+
+    m_outW = outW;  m_outH = outH;
+    m_srcW = srcW;  m_srcH = srcH;
+    m_tilesX = (outW + kTile - 1) / kTile;
+    m_tilesY = (outH + kTile - 1) / kTile;
+
+    // Source pixel-center coordinates at output pixel centers, 16.16
+    const int cw = m_tilesX + 1, ch = m_tilesY + 1;
+    m_u.resize(size_t(cw) * ch);
+    m_v.resize(m_u.size());
+    const double lim = 32000.0;   // far outside any source; keeps 16.16 in range
+    // The last corner row / column can lie past the output edge, where the
+    // mesh clamps; extend the edge slope instead
+    auto at = [&](double x, double y, double& u, double& v) {
+        const double cx = std::min(x, 1.0), cy = std::min(y, 1.0);
+        mesh.map(cx, cy, u, v);
+        const double bu = u, bv = v;
+        double u0, v0;
+        if (x > cx) { mesh.map(2 * cx - x, cy, u0, v0);  u += bu - u0;  v += bv - v0; }
+        if (y > cy) { mesh.map(cx, 2 * cy - y, u0, v0);  u += bu - u0;  v += bv - v0; }
+    };
+    for (int j = 0; j < ch; ++j) {
+        for (int i = 0; i < cw; ++i) {
+            double un, vn;
+            at((i * kTile + 0.5) / outW, (j * kTile + 0.5) / outH, un, vn);
+            const double su = std::min(std::max(un * srcW - 0.5, -lim), lim);
+            const double sv = std::min(std::max(vn * srcH - 0.5, -lim), lim);
+            m_u[size_t(j) * cw + i] = int32_t(std::lround(su * 65536.0));
+            m_v[size_t(j) * cw + i] = int32_t(std::lround(sv * 65536.0));
+        }
+    }
+
+    // Inside a tile the map is bilinear in the corners, so the corners bound it
+    m_tileSrc.resize(size_t(m_tilesX) * m_tilesY);
+    for (int ty = 0; ty < m_tilesY; ++ty) {
+        for (int tx = 0; tx < m_tilesX; ++tx) {
+            int32_t u0 = INT32_MAX, u1 = INT32_MIN, v0 = INT32_MAX, v1 = INT32_MIN;
+            for (int c = 0; c < 4; ++c) {
+                const size_t k = size_t(ty + c / 2) * cw + tx + c % 2;
+                u0 = std::min(u0, m_u[k]);  u1 = std::max(u1, m_u[k]);
+                v0 = std::min(v0, m_v[k]);  v1 = std::max(v1, m_v[k]);
+            }
+            Rect& r = m_tileSrc[size_t(ty) * m_tilesX + tx];
+            r.x0 = std::max(0, (u0 >> 16));
+            r.y0 = std::max(0, (v0 >> 16));
+            r.x1 = std::min(srcW, (u1 >> 16) + 2);   // + the right/bottom neighbour
+            r.y1 = std::min(srcH, (v1 >> 16) + 2);
+            if (r.x1 < r.x0) r.x1 = r.x0;
+            if (r.y1 < r.y0) r.y1 = r.y0;
+        }
+    }
+}
+
+WarpRemap::Rect WarpRemap::tileOutput(int tx, int ty) const
+{
+    Rect r;
+    r.x0 = tx * kTile;
+    r.y0 = ty * kTile;
+    r.x1 = std::min(r.x0 + kTile, m_outW);
+    r.y1 = std::min(r.y0 + kTile, m_outH);
+    return r;
+}
+
+WarpRemap::Rect WarpRemap::footprint(const Rect& src, uint8_t* mask) const
+{
+    int x0 = INT_MAX, y0 = INT_MAX, x1 = INT_MIN, y1 = INT_MIN;
+    for (int ty = 0; ty < m_tilesY; ++ty) {
+        for (int tx = 0; tx < m_tilesX; ++tx) {
+            const Rect& t = tileSource(tx, ty);
+            if (t.x1 <= t.x0 || t.y1 <= t.y0) continue;
+            if (t.x0 >= src.x1 || src.x0 >= t.x1 || t.y0 >= src.y1 || src.y0 >= t.y1) continue;
+            if (mask) mask[size_t(ty) * m_tilesX + tx] = 1;
+            x0 = std::min(x0, tx);  x1 = std::max(x1, tx);
+            y0 = std::min(y0, ty);  y1 = std::max(y1, ty);
+        }
+    }
+    if (x0 > x1) return Rect();
+    const Rect a = tileOutput(x0, y0), b = tileOutput(x1, y1);
+    return Rect{ a.x0, a.y0, b.x1, b.y1 };
+}
+
+void WarpRemap::apply(const uint32_t* src, int srcStride, uint32_t* dst, int dstStride,
+                      int ty0, int ty1, const uint8_t* mask, bool simd) const
+{
+    if (!isValid()) return;
+    ty0 = std::max(ty0, 0);
+    ty1 = std::min(ty1, m_tilesY);
+
+    auto row = simd ? rowSimd : rowPortable;
+    const int cw = m_tilesX + 1;
+    const int w1 = m_srcW - 1, h1 = m_srcH - 1;
+
+    for (int ty = ty0; ty < ty1; ++ty) {
+        for (int tx = 0; tx < m_tilesX; ++tx) {
+            if (mask && !mask[size_t(ty) * m_tilesX + tx]) continue;
+
+            const Rect o = tileOutput(tx, ty);
+            const size_t a = size_t(ty) * cw + tx, c = a + cw;
+            const int64_t ua = m_u[a], ub = m_u[a + 1], uc = m_u[c], ud = m_u[c + 1];
+            const int64_t va = m_v[a], vb = m_v[a + 1], vc = m_v[c], vd = m_v[c + 1];
+
+            for (int y = o.y0; y < o.y1; ++y) {
+                // Tile edges at this row, then a linear step across it
+                const int64_t fy = y - o.y0;
+                const int64_t uL = ua + (((uc - ua) * fy) >> 4), uR = ub + (((ud - ub) * fy) >> 4);
+                const int64_t vL = va + (((vc - va) * fy) >> 4), vR = vb + (((vd - vb) * fy) >> 4);
+                row(src, srcStride, w1, h1, dst + ptrdiff_t(y) * dstStride + o.x0, o.x1 - o.x0,
+                    int32_t(uL), int32_t(vL), int32_t((uR - uL) >> 4), int32_t((vR - vL) >> 4));
+            }
+        }
+    }
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class WarpMesh;
+
+// Per-frame projector warp of a 32-bit (A)RGB image.
+//
+// The mesh is resampled once into a remap table at the corners of
+// kTile x kTile output tiles (16.16 fixed-point source pixel coordinates).
+// Inside a tile the source coordinate is interpolated linearly, so a row
+// of a tile is just u += du, v += dv. Each output pixel is a bilinear
+// gather of four source pixels with 4-bit subpixel weights (the precision
+// QPainter's fast bilinear path uses), which keeps every per-channel sum in
+// 16 bits: SSE2 / NEON blend two pixels per step in 16-bit lanes, the
+// portable path does the same arithmetic two channels per 32-bit word, and
+// the results are bit-identical.
+//
+// Samples outside the source come out opaque black. Work is split by tile
+// rows so callers can spread it over threads, and per-tile masks let a
+// frame re-warp only tiles that read from changed source pixels.
+class WarpRemap {
+public:
+    static constexpr int kTile = 16;
+
+    struct Rect { int x0 = 0, y0 = 0, x1 = 0, y1 = 0; };   // half-open, pixels
+
+    void build(const WarpMesh& mesh, int outW, int outH, int srcW, int srcH);
+    void clear();
+    bool isValid() const { return m_tilesX > 0; }
+
+    int outWidth() const  { return m_outW; }
+    int outHeight() const { return m_outH; }
+    int srcWidth() const  { return m_srcW; }
+    int srcHeight() const { return m_srcH; }
+    int tilesX() const    { return m_tilesX; }
+    int tilesY() const    { return m_tilesY; }
+
+    // Source pixels a tile can read (empty if it only samples outside)
+    const Rect& tileSource(int tx, int ty) const { return m_tileSrc[size_t(ty) * m_tilesX + tx]; }
+    // Output pixels of a tile
+    Rect tileOutput(int tx, int ty) const;
+    // Marks (mask byte = 1, mask may be null) the tiles that read any pixel
+    // of src and returns the output pixels they cover (empty if none)
+    Rect footprint(const Rect& src, uint8_t* mask) const;
+
+    // Warp tile rows [ty0, ty1). Strides in pixels. Tiles with a zero mask
+    // byte (tilesX * tilesY, row-major) are skipped. simd = false forces
+    // the portable path.
+    void apply(const uint32_t* src, int srcStride, uint32_t* dst, int dstStride,
+               int ty0, int ty1, const uint8_t* mask = nullptr, bool simd = true) const;
+
+private:
+    int m_outW = 0, m_outH = 0, m_srcW = 0, m_srcH = 0;
+    int m_tilesX = 0, m_tilesY = 0;
+    std::vector<int32_t> m_u, m_v;   // (tilesX + 1) x (tilesY + 1) tile corners
+    std::vector<Rect> m_tileSrc;
+};
@@ -0,0 +1,85 @@
+// ahrs_bench: checks that AhrsFilter keeps up with a 1 kHz IMU stream.
+//
+// Feeds a synthetic 1 kHz stream (slow roll/pitch oscillation plus noise and
+// +-20% timestamp jitter) through AhrsFilter::updateAt and reports the cost
+// per sample against the 1000 us budget. Run it on the target Pi:
+//   ./ahrs_bench [seconds-of-data]
+
+#include "AhrsFilter.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+struct ImuIn {
+    long long tsUs;
+    double gx, gy, gz, ax, ay, az;
+};
+
+int main(int argc, char* argv[])
+{
+    const int seconds = (argc > 1) ? std::max(1, std::atoi(argv[1])) : 60;
+    const int n = seconds * 1000;
+
+    std::mt19937 rng(1234);
+    std::normal_distribution<double> gyroNoise(0.0, 0.01);
+    std::normal_distribution<double> accNoise(0.0, 0.2);
+    std::uniform_int_distribution<int> jitterUs(-200, 200);
+
+    std::vector<ImuIn> in(n);
+    long long ts = 1000000;
+    for (int i = 0; i < n; ++i) {
+        const double t = i * 1e-3;
+        const double roll  = 0.3 * std::sin(0.6 * t);
+        const double pitch = 0.15 * std::sin(0.45 * t);
+        ts += 1000 + jitterUs(rng);
+
+        ImuIn& s = in[i];
+        s.tsUs = ts;
+        s.gx = 0.3 * 0.6 * std::cos(0.6 * t) + gyroNoise(rng);
+        s.gy = 0.15 * 0.45 * std::cos(0.45 * t) + gyroNoise(rng);
+        s.gz = gyroNoise(rng);
+        s.ax = -9.81 * std::sin(pitch) + accNoise(rng);
+        s.ay = 9.81 * std::cos(pitch) * std::sin(roll) + accNoise(rng);
+        s.az = 9.81 * std::cos(pitch) * std::cos(roll) + accNoise(rng);
+    }
+
+    using clock = std::chrono::steady_clock;
+    AhrsFilter f(0.1);
+
+    // Per-sample timings (batched by 100 so the clock read doesn't dominate)
+    const int batch = 100;
+    std::vector<double> perSampleNs;
+    perSampleNs.reserve(n / batch);
+
+    double sink = 0.0;
+    const auto t0 = clock::now();
+    for (int i = 0; i + batch <= n; i += batch) {
+        const auto b0 = clock::now();
+        for (int k = i; k < i + batch; ++k) {
+            const ImuIn& s = in[k];
+            f.updateAt(s.tsUs, s.gx, s.gy, s.gz, s.ax, s.ay, s.az);
+            sink += f.rollRad() + f.pitchRad();
+        }
+        const auto b1 = clock::now();
+        perSampleNs.push_back(std::chrono::duration<double, std::nano>(b1 - b0).count() / batch);
+    }
+    const auto t1 = clock::now();
+
+    std::sort(perSampleNs.begin(), perSampleNs.end());
+    const double totalNs = std::chrono::duration<double, std::nano>(t1 - t0).count();
+    const double mean = totalNs / (perSampleNs.size() * batch);
+    const double p99  = perSampleNs[(size_t)(perSampleNs.size() * 0.99)];
+    const double maxv = perSampleNs.back();
+
+    std::printf("samples:        %d (%d s @ 1 kHz)\n", n, seconds);
+    std::printf("update+euler:   mean %.1f ns  p99 %.1f ns  max %.1f ns\n", mean, p99, maxv);
+    std::printf("1 kHz budget:   %.3f%% of one core\n", mean / 1e6 * 100.0);
+    std::printf("final roll/pitch: %.2f / %.2f deg (checksum %.3f)\n",
+                f.rollRad() * 180.0 / M_PI, f.pitchRad() * 180.0 / M_PI, sink);
+    return 0;
+}
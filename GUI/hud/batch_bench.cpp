@@ -0,0 +1,123 @@
+// batch_bench: offline gain sweep, scalar path vs. BatchFusion.
+//
+// Builds one synthetic flight (1 kHz IMU + mag) and sweeps AHRS beta over
+// many jobs. The scalar reference is the per-sample fusion UartCborSource
+// runs after its SampleFilter stage (AhrsFilter::updateAt + euler +
+// tilt-compensated heading), on the same unfiltered columns the batch gets.
+// Checks that the batch output is bit-identical and reports the speedup.
+//   ./batch_bench [jobs] [seconds-of-flight]
+
+#include "AhrsFilter.h"
+#include "AttitudeMath.h"
+#include "BatchFusion.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <thread>
+#include <vector>
+
+struct Outputs {
+    std::vector<double> roll, pitch, heading;
+    explicit Outputs(size_t n) : roll(n), pitch(n), heading(n) {}
+};
+
+int main(int argc, char* argv[])
+{
+    const int jobs = (argc > 1) ? std::max(1, std::atoi(argv[1])) : 64;
+    const int seconds = (argc > 2) ? std::max(1, std::atoi(argv[2])) : 60;
+    const size_t n = size_t(seconds) * 1000;
+
+    // Synthetic flight in SoA columns
+    std::mt19937 rng(7);
+    std::normal_distribution<double> noise(0.0, 1.0);
+    std::uniform_int_distribution<int> jitter(-150, 150);
+    std::vector<long long> ts(n);
+    std::vector<double> gx(n), gy(n), gz(n), ax(n), ay(n), az(n), mx(n), my(n), mz(n);
+    long long t = 0;
+    for (size_t i = 0; i < n; ++i) {
+        const double s = i * 1e-3;
+        const double roll = 0.4 * std::sin(0.5 * s), pitch = 0.1 * std::sin(0.3 * s);
+        t += 1000 + jitter(rng);
+        ts[i] = t;
+        gx[i] = 0.2 * std::cos(0.5 * s) + 0.01 * noise(rng);
+        gy[i] = 0.03 * std::cos(0.3 * s) + 0.01 * noise(rng);
+        gz[i] = 0.05 + 0.01 * noise(rng);
+        ax[i] = -9.81 * std::sin(pitch) + 0.2 * noise(rng);
+        ay[i] = 9.81 * std::cos(pitch) * std::sin(roll) + 0.2 * noise(rng);
+        az[i] = 9.81 * std::cos(pitch) * std::cos(roll) + 0.2 * noise(rng);
+        mx[i] = 20.0 * std::cos(0.05 * s) + noise(rng);
+        my[i] = 20.0 * std::sin(0.05 * s) + noise(rng);
+        mz[i] = 40.0 + noise(rng);
+    }
+
+    std::vector<double> betas(jobs);
+    for (int j = 0; j < jobs; ++j) betas[j] = 0.01 + 0.5 * j / std::max(1, jobs - 1);
+
+    using clock = std::chrono::steady_clock;
+    auto ms = [](clock::time_point a, clock::time_point b) {
+        return std::chrono::duration<double, std::milli>(b - a).count();
+    };
+
+    // Scalar reference
+    std::vector<Outputs> ref(jobs, Outputs(n));
+    const auto s0 = clock::now();
+    for (int j = 0; j < jobs; ++j) {
+        AhrsFilter f(betas[j]);
+        for (size_t i = 0; i < n; ++i) {
+            f.updateAt(ts[i], gx[i], gy[i], gz[i], ax[i], ay[i], az[i]);
+            if (!f.isInitialized()) { ref[j].roll[i] = ref[j].pitch[i] = ref[j].heading[i] = 0.0; continue; }
+            const double r = f.rollRad(), p = f.pitchRad();
+            ref[j].roll[i] = r * (180.0 / M_PI);
+            ref[j].pitch[i] = p * (180.0 / M_PI);
+            ref[j].heading[i] = tiltCompensatedHeadingDeg(r, p, mx[i], my[i], mz[i], -6.3);
+        }
+    }
+    const auto s1 = clock::now();
+
+    auto runBatch = [&](unsigned threads, std::vector<Outputs>& out) {
+        std::vector<BatchJob> bj(jobs);
+        for (int j = 0; j < jobs; ++j) {
+            SensorColumns& in = bj[j].in;
+            in.tsUs = ts.data();
+            in.gx = gx.data(); in.gy = gy.data(); in.gz = gz.data();
+            in.ax = ax.data(); in.ay = ay.data(); in.az = az.data();
+            in.mx = mx.data(); in.my = my.data(); in.mz = mz.data();
+            in.count = n;
+            bj[j].out.rollDeg = out[j].roll.data();
+            bj[j].out.pitchDeg = out[j].pitch.data();
+            bj[j].out.headingDeg = out[j].heading.data();
+            bj[j].beta = betas[j];
+            bj[j].declinationDeg = -6.3;
+        }
+        const auto b0 = clock::now();
+        runBatchFusion(bj.data(), bj.size(), threads);
+        return ms(b0, clock::now());
+    };
+
+    std::vector<Outputs> b1(jobs, Outputs(n)), bN(jobs, Outputs(n));
+    const double t1 = runBatch(1, b1);
+    const double tN = runBatch(0, bN);
+
+    auto same = [&](const std::vector<Outputs>& o) {
+        for (int j = 0; j < jobs; ++j) {
+            if (std::memcmp(o[j].roll.data(), ref[j].roll.data(), n * sizeof(double)) ||
+                std::memcmp(o[j].pitch.data(), ref[j].pitch.data(), n * sizeof(double)) ||
+                std::memcmp(o[j].heading.data(), ref[j].heading.data(), n * sizeof(double)))
+                return false;
+        }
+        return true;
+    };
+
+    const double ts_ = ms(s0, s1);
+    std::printf("%d jobs x %zu samples, %d SIMD lanes, %u threads\n",
+                jobs, n, batchFusionLanes(), std::max(1u, std::thread::hardware_concurrency()));
+    std::printf("scalar:            %8.1f ms  (%.1f ns/sample)\n", ts_, ts_ * 1e6 / (double(jobs) * n));
+    std::printf("batch, 1 thread:   %8.1f ms  x%.2f  bit-identical: %s\n", t1, ts_ / t1, same(b1) ? "yes" : "NO");
+    std::printf("batch, all cores:  %8.1f ms  x%.2f  bit-identical: %s\n", tN, ts_ / tN, same(bN) ? "yes" : "NO");
+    return (same(b1) && same(bN)) ? 0 : 1;
+}
@@ -0,0 +1,76 @@
+// fbfile_snap: reads the file stand-in of FramebufferOutput (hud --output
+// file:PATH@WxH) the way scan-out would, for testing without a display.
+//
+// Saves the current front buffer as a PNG, and with a watch time reports
+// how many flips happened in it.
+//   ./fbfile_snap hud.fb out.png [watch-seconds]
+
+#include "FramebufferOutput.h"
+
+#include <QImage>
+#include <QString>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+int main(int argc, char* argv[])
+{
+    if (argc < 3) {
+        std::fprintf(stderr, "usage: %s file.fb out.png [watch-seconds]\n", argv[0]);
+        return 2;
+    }
+
+    const int fd = ::open(argv[1], O_RDONLY);
+    struct stat st{};
+    if (fd < 0 || fstat(fd, &st) < 0 || size_t(st.st_size) < sizeof(FramebufferOutput::FileHeader)) {
+        std::fprintf(stderr, "%s: cannot open\n", argv[1]);
+        return 1;
+    }
+    void* p = mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    if (p == MAP_FAILED) {
+        std::fprintf(stderr, "%s: cannot map\n", argv[1]);
+        return 1;
+    }
+    const uint8_t* base = static_cast<const uint8_t*>(p);
+    const auto* h = reinterpret_cast<const volatile FramebufferOutput::FileHeader*>(base);
+
+    if (std::memcmp(const_cast<const char*>(h->magic), "HUDFB1", 6) != 0 ||
+        h->format != FramebufferOutput::XRGB8888 ||
+        h->dataOffset + uint64_t(h->buffers) * h->stride * h->height > uint64_t(st.st_size)) {
+        std::fprintf(stderr, "%s: not a HUD framebuffer file\n", argv[1]);
+        return 1;
+    }
+
+    if (argc > 3) {
+        const double secs = std::atof(argv[3]);
+        const uint64_t f0 = h->flips;
+        std::this_thread::sleep_for(std::chrono::duration<double>(secs));
+        const uint64_t f1 = h->flips;
+        std::printf("%llu flips in %.1f s (%.1f/s)\n", (unsigned long long)(f1 - f0), secs,
+                    secs > 0 ? (f1 - f0) / secs : 0.0);
+    }
+
+    // Front index, then its pixels (the writer publishes them in that order)
+    const uint32_t front = h->front;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const QImage img(base + h->dataOffset + size_t(front) * h->stride * h->height,
+                     int(h->width), int(h->height), int(h->stride), QImage::Format_RGB32);
+    if (!img.copy().save(QString::fromLocal8Bit(argv[2]))) {
+        std::fprintf(stderr, "%s: cannot write\n", argv[2]);
+        return 1;
+    }
+    std::printf("%ux%u front=%u flips=%llu -> %s\n", unsigned(h->width), unsigned(h->height), front,
+                (unsigned long long)h->flips, argv[2]);
+    munmap(p, size_t(st.st_size));
+    ::close(fd);
+    return 0;
+}
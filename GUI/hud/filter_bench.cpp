@@ -0,0 +1,90 @@
+// filter_bench: cost of the SampleFilter stage at 1 kHz.
+//
+// Runs a synthetic 1 kHz stream (noise + 0.5% spikes) with every numeric
+// field of HudSample (heading..T) filtered, for median and Hampel at a few
+// window sizes, and reports per-sample cost against the 1000 us budget.
+// Then checks that Hampel (k = 3) leaves clean Gaussian noise alone: the
+// rejected share should stay near the 0.27% beyond 3 sigma at every window.
+//   ./filter_bench [seconds-of-data]
+
+#include "SampleFilter.h"
+#include "RobustFilter.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+int main(int argc, char* argv[])
+{
+    const int seconds = (argc > 1) ? std::max(1, std::atoi(argv[1])) : 30;
+    const int n = seconds * 1000;
+
+    std::mt19937 rng(42);
+    std::normal_distribution<double> noise(0.0, 1.0);
+    std::uniform_real_distribution<double> u(0.0, 1.0);
+
+    std::vector<HudSample> in(n);
+    for (int i = 0; i < n; ++i) {
+        const double t = i * 1e-3;
+        HudSample& s = in[i];
+        s.headingDeg = std::fmod(350.0 + 5.0 * t, 360.0) + 0.2 * noise(rng);
+        s.rollDeg = 10.0 * std::sin(0.5 * t) + 0.2 * noise(rng);
+        s.pitchDeg = 3.0 * std::sin(0.3 * t) + 0.2 * noise(rng);
+        s.altitudeFt = 1000.0 + 20.0 * t + noise(rng);
+        s.vspeedFpm = 1200.0 + 30.0 * noise(rng);
+        s.ax = 0.1 * noise(rng); s.ay = 0.1 * noise(rng); s.az = 9.81 + 0.1 * noise(rng);
+        s.gx = 0.01 * noise(rng); s.gy = 0.01 * noise(rng); s.gz = 0.01 * noise(rng);
+        s.mx = 20.0 + noise(rng); s.my = -5.0 + noise(rng); s.mz = 40.0 + noise(rng);
+        s.pressureHpa = 1013.0 + 0.02 * noise(rng);
+        s.tempC = 23.0 + 0.05 * noise(rng);
+        if (u(rng) < 0.005) { s.az += 50.0; s.altitudeFt += 500.0; s.mx -= 100.0; }
+    }
+
+    std::printf("%d samples x %d fields (%d s @ 1 kHz)\n", n, SampleFilter::kFieldCount, seconds);
+
+    using clock = std::chrono::steady_clock;
+    const char* modes[] = { "median", "hampel" };
+    const int windows[] = { 5, 7, 15, 31, 63 };
+
+    for (const char* mode : modes) {
+        for (int w : windows) {
+            SampleFilter f;
+            f.configure("all=" + std::string(mode) + ":" + std::to_string(w) + ":3");
+
+            std::vector<HudSample> work = in;
+            double sink = 0.0;
+            const auto t0 = clock::now();
+            for (HudSample& s : work) {
+                f.apply(s);
+                sink += s.az;
+            }
+            const auto t1 = clock::now();
+
+            const double ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / n;
+            unsigned long long rej = 0;
+            for (int k = 0; k < SampleFilter::kFieldCount; ++k) rej += f.rejected(k);
+            std::printf("%-6s w=%-2d  %7.1f ns/sample (%5.1f ns/field)  %.3f%% of 1 kHz budget  rejected=%llu  [%.1f]\n",
+                        mode, w, ns, ns / SampleFilter::kFieldCount, ns / 1e6 * 100.0, rej, sink / n);
+        }
+    }
+
+    // Clean N(0,1), no spikes: only the Gaussian tail should be rejected
+    bool ok = true;
+    for (int w : windows) {
+        std::mt19937 clean(7);
+        HampelFilter f(w, 3.0);
+        const int m = 1000000;
+        for (int i = 0; i < m; ++i) f.filter(noise(clean));
+        const double pct = 100.0 * double(f.rejected()) / m;
+        const bool pass = pct < 0.4;
+        ok = ok && pass;
+        std::printf("clean  w=%-2d  rejected %.3f%%  %s\n", w, pct, pass ? "ok" : "too many");
+    }
+    std::printf("%s\n", ok ? "PASS" : "FAIL");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,63 @@
+// hudrec_export: turns a HUD recording (hud --record) into a PNG sequence.
+//
+// Writes frame_NNNNNN.png for every Nth frame plus frames.csv with the
+// timestamps of every frame (steady paint time, device sample time, steady
+// arrival time of that sample), so frames can be lined up with the flight
+// log and the sample's age on screen read off.
+//   ./hudrec_export recording.hudrec outdir [every-nth]
+
+#include "FrameRecorder.h"
+
+#include <QDir>
+#include <QFile>
+#include <QImage>
+#include <QString>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+int main(int argc, char* argv[])
+{
+    if (argc < 3) {
+        std::fprintf(stderr, "usage: %s recording.hudrec outdir [every-nth]\n", argv[0]);
+        return 2;
+    }
+    const int every = (argc > 3) ? std::max(1, std::atoi(argv[3])) : 1;
+
+    FrameRecorder::Reader reader;
+    if (!reader.open(argv[1])) {
+        std::fprintf(stderr, "%s: not a HUD recording\n", argv[1]);
+        return 1;
+    }
+    const QString outDir = QString::fromLocal8Bit(argv[2]);
+    QDir().mkpath(outDir);
+
+    FILE* csv = std::fopen(QFile::encodeName(outDir + "/frames.csv").constData(), "w");
+    if (!csv) {
+        std::fprintf(stderr, "%s: cannot write frames.csv\n", argv[2]);
+        return 1;
+    }
+    std::fprintf(csv, "frame,key,width,height,frame_us,sample_ts_us,sample_host_us,png\n");
+
+    std::vector<uint32_t> canvas;
+    FrameRecorder::FrameHeader h;
+    int n = 0, written = 0;
+    for (; reader.next(canvas, h); ++n) {
+        QString png;
+        if (n % every == 0) {
+            png = QString("frame_%1.png").arg(n, 6, 10, QChar('0'));
+            const QImage img(reinterpret_cast<const uchar*>(canvas.data()), h.width, h.height,
+                             h.width * 4, QImage::Format_RGB32);
+            if (img.save(outDir + "/" + png)) ++written;
+            else png.clear();
+        }
+        std::fprintf(csv, "%d,%d,%d,%d,%lld,%lld,%lld,%s\n", n, (h.flags & FrameRecorder::kKeyFrame) ? 1 : 0,
+                     h.width, h.height, (long long)h.meta.frameUs, (long long)h.meta.sampleTsUs,
+                     (long long)h.meta.sampleHostUs, png.toUtf8().constData());
+    }
+    std::fclose(csv);
+    std::printf("%d frames, %d PNGs in %s\n", n, written, argv[2]);
+    return 0;
+}
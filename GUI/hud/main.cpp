@@ -5,10 +5,25 @@
 #include <QDebug>
 #include <QCommandLineParser>
 #include <QProcessEnvironment>
+#include <QStandardPaths>
+#include <QElapsedTimer>
+
+#include <memory>
+#include <vector>
 
 #include "HudWidget.h"
+#include "HudQuickView.h"
+#include "HudMirror.h"
+#include "FrameScheduler.h"
+#include "IdlePolicy.h"
+#include "QualityGovernor.h"
+#include "WarpMesh.h"
+#include "FrameRecorder.h"
+#include "FramebufferOutput.h"
 #include "DummyDataSource.h"
 #include "UartCborSource.h"
+#include "AttitudePredictor.h"
+#include "PlayoutBuffer.h"
 
 static bool isDevMode(QApplication& app, QCommandLineParser& parser)
 {
@@ -34,8 +49,38 @@ static QScreen* pickExternalScreen(QApplication& app)
     return app.primaryScreen();
 }
 
+// Same placement as the widget path, for the QtQuick window
+static void placeWindow(QApplication& app, QWindow* win, bool devMode)
+{
+    if (devMode) {
+        if (auto* primary = app.primaryScreen()) {
+            win->setPosition(primary->geometry().topLeft());
+        }
+        win->showMaximized();
+        return;
+    }
+
+    if (QScreen* target = pickExternalScreen(app)) {
+        win->setScreen(target);
+        win->setPosition(target->geometry().topLeft());
+    }
+    win->showFullScreen();
+}
+
+// --output renders without a window system; pick the offscreen platform
+// plugin before QApplication looks for a display
+static bool wantsDirectOutput(int argc, char *argv[])
+{
+    for (int i = 1; i < argc; ++i)
+        if (qstrcmp(argv[i], "--output") == 0 || qstrncmp(argv[i], "--output=", 9) == 0)
+            return true;
+    return false;
+}
+
 int main(int argc, char *argv[])
 {
+    if (wantsDirectOutput(argc, argv) && !qEnvironmentVariableIsSet("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
     QApplication app(argc, argv);
     app.setApplicationName("PEGASUS HUD");
 
@@ -53,11 +98,117 @@ int main(int argc, char *argv[])
     QCommandLineOption baudOpt(QStringList() << "b" << "baud",
                             "UART baud rate.",
                             "baud", "115200");
+    QCommandLineOption betaOpt(QStringList() << "ahrs-beta",
+                            "Host AHRS gain (Madgwick beta). Higher = trust accel more.",
+                            "beta", "0.1");
+    QCommandLineOption magCalOpt(QStringList() << "mag-cal",
+                            "Magnetometer calibration file (loaded at startup).",
+                            "file",
+                            QStandardPaths::writableLocation(QStandardPaths::AppConfigLocation)
+                                + "/magcal.txt");
+    QCommandLineOption magCalibrateOpt(QStringList() << "mag-calibrate",
+                            "Fit a new magnetometer calibration and save it to --mag-cal.");
+    QCommandLineOption declOpt(QStringList() << "declination",
+                            "Magnetic declination in degrees (east positive).",
+                            "deg", "-6.3");
+    QCommandLineOption noPredictOpt(QStringList() << "no-predict",
+                            "Draw the last received attitude instead of extrapolating to display time.");
+    QCommandLineOption horizonOpt(QStringList() << "predict-horizon-ms",
+                            "Maximum attitude extrapolation.",
+                            "ms", "50");
+    QCommandLineOption dispLatOpt(QStringList() << "display-latency-ms",
+                            "Render -> photon latency of the display/projector.",
+                            "ms", "17");
+    QCommandLineOption predictStatsOpt(QStringList() << "predict-stats",
+                            "Log predicted vs. actual attitude error every 5 s.");
+    QCommandLineOption filterOpt(QStringList() << "filter",
+                            "Raw sensor filters, e.g. \"accel=hampel:9:3,alt=median:5\" or \"none\".",
+                            "spec");
+    QCommandLineOption jitterOpt(QStringList() << "jitter-buffer",
+                            "Play UART samples out by device timestamp instead of arrival (smoother, adds delay).");
+    QCommandLineOption jitterExtraOpt(QStringList() << "jitter-extra-ms",
+                            "Extra playout delay on top of the measured jitter.",
+                            "ms", "2");
+    QCommandLineOption noStaticCacheOpt(QStringList() << "no-static-cache",
+                            "Redraw outlines and fixed labels every frame instead of blitting a cached layer.");
+    QCommandLineOption paintStatsOpt(QStringList() << "paint-stats",
+                            "Log HUD paint time every 5 s.");
+    QCommandLineOption quickOpt(QStringList() << "quick",
+                            "Render with the QtQuick scene graph instead of QPainter (threaded render loop; "
+                            "QT_QUICK_BACKEND=software is supported).");
+    QCommandLineOption parallelOpt(QStringList() << "parallel-raster",
+                            "Rasterize instruments on worker threads (N threads, 0 = cores - 1).",
+                            "threads");
+    QCommandLineOption qualityOpt(QStringList() << "quality",
+                            "Render quality: \"auto\" (degrade when over the frame budget) or a fixed level 0-3.",
+                            "level", "auto");
+    QCommandLineOption budgetOpt(QStringList() << "frame-budget-ms",
+                            "Paint time budget for --quality auto (0 = 70% of the refresh period).",
+                            "ms", "0");
+    QCommandLineOption noPaceOpt(QStringList() << "no-vsync-pace",
+                            "Repaint on every sample / dummy tick instead of once per display refresh.");
+    QCommandLineOption renderAheadOpt(QStringList() << "render-ahead-ms",
+                            "Start each paced frame this long before vsync (smaller = less latency, more misses).",
+                            "ms", "4");
+    QCommandLineOption refreshOpt(QStringList() << "refresh-hz",
+                            "Display refresh rate for pacing (0 = ask QScreen).",
+                            "hz", "0");
+    QCommandLineOption idleAfterOpt(QStringList() << "idle-after-ms",
+                            "Paced: render at a fraction of the refresh rate once nothing visible has changed "
+                            "for this long; the next change renders at the next vblank (0 = off).",
+                            "ms", "2000");
+    QCommandLineOption warpOpt(QStringList() << "warp",
+                            "Projector warp mesh from grid_test --calibrate (used if the file exists).",
+                            "file",
+                            QStandardPaths::writableLocation(QStandardPaths::AppConfigLocation)
+                                + "/warp.txt");
+    QCommandLineOption noWarpOpt(QStringList() << "no-warp",
+                            "Do not apply the projector warp.");
+    QCommandLineOption perfOverlayOpt(QStringList() << "perf-overlay",
+                            "Show the performance overlay at startup (F3 toggles it).");
+    QCommandLineOption recordOpt(QStringList() << "record",
+                            "Record the displayed frames with sample timestamps (.hudrec, see hudrec_export).",
+                            "file");
+    QCommandLineOption outputOpt(QStringList() << "output",
+                            "Present straight to a display without X / Wayland: drm:/dev/dri/card0, fb:/dev/fb0, "
+                            "or file:PATH@WxH as a stand-in (see fbfile_snap). Implies vsync pacing.",
+                            "spec");
+    QCommandLineOption mirrorOpt(QStringList() << "mirror",
+                            "Also show the HUD on screen N, rendered once and copied (repeatable). "
+                            "Options after the index: fit (default) or stretch, warp=FILE.",
+                            "N[,fit|stretch][,warp=FILE]");
 
     parser.addOption(devOpt);
     parser.addOption(dummyOpt);
     parser.addOption(portOpt);
     parser.addOption(baudOpt);
+    parser.addOption(betaOpt);
+    parser.addOption(magCalOpt);
+    parser.addOption(magCalibrateOpt);
+    parser.addOption(declOpt);
+    parser.addOption(noPredictOpt);
+    parser.addOption(horizonOpt);
+    parser.addOption(dispLatOpt);
+    parser.addOption(predictStatsOpt);
+    parser.addOption(filterOpt);
+    parser.addOption(jitterOpt);
+    parser.addOption(jitterExtraOpt);
+    parser.addOption(noStaticCacheOpt);
+    parser.addOption(paintStatsOpt);
+    parser.addOption(quickOpt);
+    parser.addOption(parallelOpt);
+    parser.addOption(qualityOpt);
+    parser.addOption(budgetOpt);
+    parser.addOption(noPaceOpt);
+    parser.addOption(renderAheadOpt);
+    parser.addOption(refreshOpt);
+    parser.addOption(idleAfterOpt);
+    parser.addOption(warpOpt);
+    parser.addOption(noWarpOpt);
+    parser.addOption(recordOpt);
+    parser.addOption(perfOverlayOpt);
+    parser.addOption(outputOpt);
+    parser.addOption(mirrorOpt);
 
     parser.process(app);
 
@@ -66,18 +217,162 @@ int main(int argc, char *argv[])
 
     HudWidget hud;
     hud.resize(1280, 720);
+    hud.setStaticLayerEnabled(!parser.isSet(noStaticCacheOpt));
+    if (parser.isSet(parallelOpt)) hud.setParallelRaster(true, parser.value(parallelOpt).toInt());
+
+    // ---- Direct output (no window) ----
+    FramebufferOutput output;
+    const bool direct = parser.isSet(outputOpt);
+    if (direct) {
+        std::string error;
+        if (!output.open(parser.value(outputOpt).toStdString(), &error)) {
+            qDebug().noquote() << "Output" << parser.value(outputOpt) << "failed:" << QString::fromStdString(error);
+            return 1;
+        }
+        qDebug().noquote() << QString("Output %1 %2x%3, %4 buffer(s), %5 Hz")
+                              .arg(output.kind()).arg(output.width()).arg(output.height())
+                              .arg(output.bufferCount()).arg(output.refreshHz(), 0, 'f', 2);
+        if (parser.isSet(quickOpt)) qDebug() << "--quick is ignored with --output";
+    }
+
+    std::unique_ptr<HudQuickView> quick;
+    if (direct) {
+        hud.setOutput(&output);
+    } else if (parser.isSet(quickOpt)) {
+        // Scene sync and GL/software rendering off the GUI thread
+        if (!qEnvironmentVariableIsSet("QSG_RENDER_LOOP"))
+            qputenv("QSG_RENDER_LOOP", "threaded");
+        quick.reset(new HudQuickView);
+        quick->resize(1280, 720);
+        quick->show();
+    } else {
+        // Show once first so a native window exists (prevents WSL/Wayland segfaults)
+        hud.show();
+    }
 
-    // Show once first so a native window exists (prevents WSL/Wayland segfaults)
-    hud.show();
+    // ---- Frame pacing (widget renderer; the scene graph paces itself) ----
+    FrameScheduler pacer;
+    IdlePolicy idle;
+    const bool paced = direct || (!quick && !parser.isSet(noPaceOpt));
+    if (paced) {
+        hud.setExternalPacing(true);
+        pacer.setRenderAheadUs((qint64)(parser.value(renderAheadOpt).toDouble() * 1000.0));
+        const double hz = parser.value(refreshOpt).toDouble();
+        if (hz > 0) {
+            pacer.setRefreshHz(hz);
+        } else if (direct) {
+            if (output.refreshHz() > 0) pacer.setRefreshHz(output.refreshHz());
+        } else if (QWindow* w = hud.windowHandle()) {
+            pacer.setScreen(w->screen());
+            QObject::connect(w, &QWindow::screenChanged, &pacer, &FrameScheduler::setScreen);
+        }
+        idle.setIdleAfterUs((qint64)(parser.value(idleAfterOpt).toDouble() * 1000.0));
+    }
+
+    // ---- Projector warp (widget renderer) ----
+    if (!parser.isSet(noWarpOpt)) {
+        WarpMesh mesh;
+        if (mesh.load(parser.value(warpOpt).toStdString())) {
+            hud.setWarp(mesh);
+            qDebug() << "Projector warp:" << parser.value(warpOpt);
+        } else if (parser.isSet(warpOpt)) {
+            qDebug() << "Could not load warp" << parser.value(warpOpt);
+        }
+    }
+
+    // ---- Frame recording (widget renderer) ----
+    FrameRecorder recorder;
+    if (parser.isSet(recordOpt)) {
+        if (recorder.start(parser.value(recordOpt).toStdString())) {
+            hud.setRecorder(&recorder);
+            qDebug() << "Recording frames to" << parser.value(recordOpt);
+        } else {
+            qDebug() << "Could not open" << parser.value(recordOpt) << "for recording";
+        }
+    }
+
+    // ---- Mirrors (widget renderer): the same frame on more screens ----
+    std::vector<std::unique_ptr<HudMirror>> mirrors;
+    std::vector<int> mirrorScreens;
+    if (!quick && !direct) {
+        for (const QString& spec : parser.values(mirrorOpt)) {
+            const QStringList parts = spec.split(',');
+            bool ok = false;
+            const int screen = parts.value(0).toInt(&ok);
+            if (!ok) {
+                qDebug() << "Bad --mirror" << spec;
+                continue;
+            }
+            std::unique_ptr<HudMirror> m(new HudMirror);
+            m->setWindowTitle(QString("PEGASUS HUD mirror %1").arg(screen));
+            for (int i = 1; i < parts.size(); ++i) {
+                const QString opt = parts[i].trimmed();
+                if (opt == QLatin1String("stretch")) {
+                    m->setScaling(HudMirror::Stretch);
+                } else if (opt == QLatin1String("fit")) {
+                    m->setScaling(HudMirror::Fit);
+                } else if (opt.startsWith(QLatin1String("warp="))) {
+                    WarpMesh mesh;
+                    if (mesh.load(opt.mid(5).toStdString())) m->setWarp(mesh);
+                    else qDebug() << "Could not load mirror warp" << opt.mid(5);
+                } else {
+                    qDebug() << "Unknown --mirror option" << opt;
+                }
+            }
+            hud.addMirror(m.get());
+            mirrors.push_back(std::move(m));
+            mirrorScreens.push_back(screen);
+        }
+    } else if (parser.isSet(mirrorOpt)) {
+        qDebug() << "--mirror needs the windowed widget renderer (not --quick / --output)";
+    }
+
+    // ---- Render quality ----
+    QualityGovernor governor;
+    if (parser.value(qualityOpt) == QLatin1String("auto")) {
+        double budgetMs = parser.value(budgetOpt).toDouble();
+        if (budgetMs <= 0) {
+            double hz = parser.value(refreshOpt).toDouble();
+            if (hz <= 0 && direct) hz = output.refreshHz();
+            else if (hz <= 0 && hud.windowHandle()) hz = hud.windowHandle()->screen()->refreshRate();
+            budgetMs = 0.7 * 1000.0 / (hz >= 20.0 ? hz : 60.0);
+        }
+        governor.setBudgetUs(budgetMs * 1000.0);
+        hud.setQualityGovernor(&governor);
+    } else {
+        hud.setQualityLevel(parser.value(qualityOpt).toInt());
+    }
 
     // Screen placement after window exists
     QTimer::singleShot(0, [&](){
+        if (direct) return;
         const auto screens = app.screens();
         qDebug() << "Detected screens:";
         for (int i = 0; i < screens.size(); ++i) {
             qDebug() << " " << i << screens[i]->name() << screens[i]->geometry();
         }
 
+        if (quick) {
+            placeWindow(app, quick.get(), devMode);
+            return;
+        }
+
+        // Mirrors full screen on theirs; plain windows in dev mode
+        for (size_t i = 0; i < mirrors.size(); ++i) {
+            HudMirror* m = mirrors[i].get();
+            const int idx = mirrorScreens[i];
+            if (devMode || idx < 0 || idx >= screens.size()) {
+                if (!devMode) qDebug() << "Mirror screen" << idx << "not found; showing a window";
+                m->resize(640, 360);
+                m->show();
+                continue;
+            }
+            m->show();
+            if (m->windowHandle()) m->windowHandle()->setScreen(screens[idx]);
+            m->move(screens[idx]->geometry().topLeft());
+            m->showFullScreen();
+        }
+
         if (devMode) {
             if (auto* primary = app.primaryScreen()) {
                 hud.move(primary->geometry().topLeft());
@@ -94,6 +389,79 @@ int main(int argc, char *argv[])
         hud.showFullScreen();
     });
 
+    // ---- Display-time prediction ----
+    AttitudePredictor predictor;
+    predictor.setEnabled(!parser.isSet(noPredictOpt));
+    predictor.setMaxHorizonUs((long long)(parser.value(horizonOpt).toDouble() * 1000.0));
+    predictor.setDisplayLatencyUs((long long)(parser.value(dispLatOpt).toDouble() * 1000.0));
+    // ~150 byte frame at 10 bits/byte on the wire
+    predictor.setInputLatencyUs(1500LL * 1000000LL / qMax(1200, parser.value(baudOpt).toInt()));
+    predictor.setStatsEnabled(parser.isSet(predictStatsOpt));
+    hud.setPredictor(&predictor);
+    if (quick) quick->setPredictor(&predictor);
+
+    QTimer statsTimer;
+    if (parser.isSet(predictStatsOpt)) {
+        QObject::connect(&statsTimer, &QTimer::timeout, [&](){
+            const AttitudePredictor::Stats st = predictor.takeStats();
+            qDebug().noquote() << QString("predict n=%1 lat=%2ms  rms roll %3/%4  pitch %5/%6  hdg %7/%8 (pred/hold deg)")
+                                  .arg(st.count).arg(st.meanLatencyMs, 0, 'f', 1)
+                                  .arg(st.rmsPredRollDeg, 0, 'f', 2).arg(st.rmsHoldRollDeg, 0, 'f', 2)
+                                  .arg(st.rmsPredPitchDeg, 0, 'f', 2).arg(st.rmsHoldPitchDeg, 0, 'f', 2)
+                                  .arg(st.rmsPredHeadingDeg, 0, 'f', 2).arg(st.rmsHoldHeadingDeg, 0, 'f', 2);
+        });
+        statsTimer.start(5000);
+    }
+
+    QTimer paintStats;
+    if (parser.isSet(paintStatsOpt)) {
+        QObject::connect(&paintStats, &QTimer::timeout, [&](){
+            if (quick) {
+                const HudQuickView::FrameStats st = quick->takeFrameStats();
+                qDebug().noquote() << QString("quick frames=%1 mean=%2us max=%3us backend=%4")
+                                      .arg(st.frames)
+                                      .arg(st.meanUs, 0, 'f', 0).arg(st.maxUs, 0, 'f', 0)
+                                      .arg(QQuickWindow::sceneGraphBackend().isEmpty()
+                                               ? QStringLiteral("default") : QQuickWindow::sceneGraphBackend());
+                return;
+            }
+            const HudWidget::PaintStats st = hud.takePaintStats();
+            const QualityGovernor::Stats gs = governor.takeStats();
+            qDebug().noquote() << QString("paint frames=%1 skipped=%2 mean=%3us max=%4us static-cache=%5 quality=%6 (down %7 up %8)")
+                                  .arg(st.frames).arg(st.skipped)
+                                  .arg(st.meanUs, 0, 'f', 0).arg(st.maxUs, 0, 'f', 0)
+                                  .arg(parser.isSet(noStaticCacheOpt) ? "off" : "on")
+                                  .arg(st.quality).arg(gs.stepsDown).arg(gs.stepsUp);
+            if (paced) {
+                const FrameScheduler::Stats ps = pacer.takeStats();
+                qDebug().noquote() << QString("pace hz=%1 frames=%2 missed=%3 wake-err=%4us render mean=%5us max=%6us phase=%7")
+                                      .arg(ps.refreshHz, 0, 'f', 2).arg(ps.frames).arg(ps.missed)
+                                      .arg(ps.meanWakeErrUs, 0, 'f', 0)
+                                      .arg(ps.meanRenderUs, 0, 'f', 0).arg(ps.maxRenderUs, 0, 'f', 0)
+                                      .arg(ps.phaseLocked ? "vsync" : "free");
+                const IdlePolicy::Stats is = idle.takeStats(AttitudePredictor::steadyNowUs());
+                qDebug().noquote() << QString("idle %1% wakes=%2 divider=%3")
+                                      .arg(is.idleFraction * 100.0, 0, 'f', 0)
+                                      .arg(is.wakes).arg(idle.divider());
+            }
+            if (direct) {
+                const FramebufferOutput::Stats os = output.takeStats();
+                qDebug().noquote() << QString("output %1 flips=%2 copy=%3us wait mean=%4us max=%5us")
+                                      .arg(output.kind()).arg(os.flips)
+                                      .arg(os.meanCopyUs, 0, 'f', 0)
+                                      .arg(os.meanWaitUs, 0, 'f', 0).arg(os.maxWaitUs, 0, 'f', 0);
+            }
+            if (recorder.isRecording()) {
+                const FrameRecorder::Stats rs = recorder.takeStats();
+                qDebug().noquote() << QString("record frames=%1 dropped=%2 key=%3 encode mean=%4us size=%5MB")
+                                      .arg(rs.frames).arg(rs.dropped).arg(rs.keyFrames)
+                                      .arg(rs.meanEncodeUs, 0, 'f', 0)
+                                      .arg(rs.bytes / 1048576.0, 0, 'f', 1);
+            }
+        });
+        paintStats.start(5000);
+    }
+
     // ---- Data sources ----
     DummyDataSource dummy(&app);
     dummy.baseAltFt = 35000.0;
@@ -101,16 +469,108 @@ int main(int argc, char *argv[])
     dummy.periodSec = 5.0;
 
     UartCborSource uart(&app);
+    uart.setAhrsBeta(parser.value(betaOpt).toDouble());
+    uart.setDeclinationDeg(parser.value(declOpt).toDouble());
     QObject::connect(&uart, &UartCborSource::logLine, [&](const QString& s){
         qDebug().noquote() << s;
     });
-    QObject::connect(&uart, &UartCborSource::sampleReady, [&](const HudSample& s){
-        hud.setHeadingDeg(s.headingDeg);
-        hud.setRollDeg(s.rollDeg);
-        hud.setPitchDeg(s.pitchDeg);
-        hud.setAltitudeFt(s.altitudeFt);
-        hud.setVSpeedFpm(s.vspeedFpm);
+    HudSample latest;
+    bool haveLatest = false, freshSample = false;
+    bool pollDummy = false;
+    quint64 samplesSeen = 0;
+    qint64 lastVblankUs = 0;
+    auto applySample = [&](HudSample s){
+        ++samplesSeen;
+        if (!s.hostUs) s.hostUs = AttitudePredictor::steadyNowUs();   // dummy source
+        predictor.addSample(s, AttitudePredictor::steadyNowUs());
+        if (quick) quick->setSample(s);
+        else if (paced) {
+            latest = s;
+            haveLatest = freshSample = true;
+            // Idling: look now, so a visible change doesn't wait for the
+            // next idle frame
+            if (idle.idle()) {
+                hud.setSample(latest);
+                freshSample = false;
+                if (hud.hasPendingFrame()) {
+                    idle.wake(AttitudePredictor::steadyNowUs());
+                    pacer.wake();
+                }
+            }
+        }
+        else hud.setSample(s);
+    };
+
+    // One render per refresh from the newest state. Prediction moves the
+    // attitude between samples, so with it on every frame is re-judged.
+    QObject::connect(&pacer, &FrameScheduler::frame, [&](qint64 vsyncUs){
+        if (direct) output.setFrameTarget(vsyncUs);
+        if (pollDummy) applySample(dummy.read());
+        if (freshSample || (haveLatest && predictor.isEnabled())) {
+            hud.setSample(latest);
+            freshSample = false;
+        }
+        pacer.setDivider(idle.update(hud.renderPending(), AttitudePredictor::steadyNowUs()));
+        // KMS reports when each flip hit the screen, and for which frame
+        const FramebufferOutput::Flip flip = direct ? output.lastFlip() : FramebufferOutput::Flip();
+        if (flip.vblankUs && flip.vblankUs != lastVblankUs) {
+            lastVblankUs = flip.vblankUs;
+            pacer.noteFlip(flip.vblankUs, flip.targetUs);
+        }
+    });
+    if (paced) pacer.start();
+
+    // Optional playout buffer between UART and HUD
+    PlayoutBuffer playout(&app);
+    playout.setExtraDelayUs((qint64)(parser.value(jitterExtraOpt).toDouble() * 1000.0));
+    QTimer playoutStats;
+    if (parser.isSet(jitterOpt)) {
+        QObject::connect(&uart, &UartCborSource::sampleReady, &playout, &PlayoutBuffer::push);
+        QObject::connect(&playout, &PlayoutBuffer::sampleReady, applySample);
+        QObject::connect(&playoutStats, &QTimer::timeout, [&](){
+            const PlayoutBuffer::Stats st = playout.stats();
+            qDebug().noquote() << QString("playout delay=%1ms jitter=%2ms depth=%3 played=%4 underruns=%5 overflows=%6")
+                                  .arg(st.targetDelayMs, 0, 'f', 1).arg(st.jitterMs, 0, 'f', 1)
+                                  .arg(st.depth).arg(st.played).arg(st.underruns).arg(st.overflows);
+        });
+        playoutStats.start(5000);
+    } else {
+        QObject::connect(&uart, &UartCborSource::sampleReady, applySample);
+    }
+
+    // ---- Performance overlay: link side, at the overlay's 2 Hz ----
+    QTimer perfTimer;
+    QElapsedTimer perfClock;
+    UartCborSource::LinkStats lastLink;
+    quint64 lastSamples = 0;
+    QObject::connect(&perfTimer, &QTimer::timeout, [&](){
+        const double secs = qMax(1e-3, perfClock.restart() / 1000.0);
+        const UartCborSource::LinkStats ls = uart.linkStats();
+        const quint64 crc = ls.badCrc - lastLink.badCrc, len = ls.badLen - lastLink.badLen;
+        const quint64 frames = (ls.ok - lastLink.ok) + crc + len + (ls.badCbor - lastLink.badCbor);
+
+        HudWidget::PerfInput in;
+        in.samplesPerSec = (samplesSeen - lastSamples) / secs;
+        in.crcErrorPct = frames ? 100.0 * crc / frames : 0.0;
+        in.lenErrorPct = frames ? 100.0 * len / frames : 0.0;
+        in.queueDepth = parser.isSet(jitterOpt) ? playout.stats().depth : -1;
+        hud.setPerfInput(in);
+        lastLink = ls;
+        lastSamples = samplesSeen;
     });
+    if (!quick) {
+        hud.setPerfOverlay(parser.isSet(perfOverlayOpt));
+        perfClock.start();
+        perfTimer.start(500);
+    }
+
+    if (parser.isSet(filterOpt)) uart.setFilterSpec(parser.value(filterOpt));
+
+    if (parser.isSet(magCalibrateOpt)) {
+        uart.startMagCalibration(parser.value(magCalOpt));
+    } else if (!uart.loadMagCalibration(parser.value(magCalOpt))) {
+        qDebug() << "No mag calibration; heading uses raw magnetometer.";
+    }
 
     const bool forceDummy = parser.isSet(dummyOpt);
     if (!forceDummy) {
@@ -124,17 +584,18 @@ int main(int argc, char *argv[])
         }
     }
 
+    // Paced: the dummy source is read at each frame instead
+    if (paced) {
+        pollDummy = true;
+        return app.exec();
+    }
+
     // Dummy polling @ ~60Hz
     QTimer tick;
     tick.setTimerType(Qt::PreciseTimer);
 
     QObject::connect(&tick, &QTimer::timeout, [&](){
-        HudSample s = dummy.read();
-        hud.setHeadingDeg(s.headingDeg);
-        hud.setRollDeg(s.rollDeg);
-        hud.setPitchDeg(s.pitchDeg);
-        hud.setAltitudeFt(s.altitudeFt);
-        hud.setVSpeedFpm(s.vspeedFpm);
+        applySample(dummy.read());
     });
 
     tick.start(16);
@@ -0,0 +1,190 @@
+// GUI/hud/qml/Hud.qml
+// QtQuick counterpart of HudWidget: same layout fractions and font sizes.
+// Static outlines/labels are plain items; the tapes and the attitude ball
+// are retained scene-graph nodes (HudQuickItems.cpp).
+
+import QtQuick 2.15
+import Pegasus.Hud 1.0
+
+Rectangle {
+    id: root
+    color: "black"
+
+    readonly property color ink: "#e6e6e6"
+
+    // HudWidget::layout()
+    readonly property rect headingRect:  Qt.rect(width*0.30, height*0.05, width*0.40, height*0.10)
+    readonly property rect attitudeRect: Qt.rect(width*0.37, height*0.24, width*0.26, height*0.42)
+    readonly property rect altitudeRect: Qt.rect(width*0.67, height*0.24, width*0.10, height*0.42)
+    readonly property rect bottomRect:   Qt.rect(width*0.35, height*0.75, width*0.30, height*0.10)
+    readonly property rect iconsRect:    Qt.rect(width*0.90, height*0.84, width*0.08, height*0.10)
+
+    component Box: Rectangle {
+        color: "transparent"
+        border.color: root.ink
+        border.width: 2
+        radius: 2
+    }
+
+    component Label: Text {
+        color: root.ink
+        horizontalAlignment: Text.AlignHCenter
+    }
+
+    // ---- Heading ----
+    Item {
+        x: headingRect.x; y: headingRect.y
+        width: headingRect.width; height: headingRect.height
+
+        HudTape {
+            x: 10; y: 10
+            width: parent.width - 20; height: parent.height - 20
+            kind: HudTape.Heading
+            value: hud.headingDeg
+            labelPointSize: parent.height*0.18
+        }
+        Box { anchors.fill: parent }
+        Rectangle {   // center marker
+            x: parent.width/2 - 1; y: -10
+            width: 2; height: 18
+            color: root.ink
+        }
+        Box {
+            x: parent.width*0.43; y: parent.height*0.38
+            width: parent.width*0.14; height: parent.height*0.24
+            radius: 0
+            Label {
+                anchors.fill: parent
+                verticalAlignment: Text.AlignVCenter
+                font.pointSize: headingRect.height*0.22
+                text: hud.headingText
+            }
+        }
+        Label {
+            y: parent.height + 2; width: parent.width
+            font.pointSize: parent.height*0.14
+            text: "HEADING"
+        }
+    }
+
+    // ---- Attitude ----
+    HudAttitude {
+        x: attitudeRect.x; y: attitudeRect.y
+        width: attitudeRect.width; height: attitudeRect.height
+        rollDeg: hud.rollDeg
+        pitchDeg: hud.pitchDeg
+        ladderPointSize: height*0.06
+    }
+    Label {
+        x: attitudeRect.x; y: attitudeRect.y + attitudeRect.height + 4
+        width: attitudeRect.width
+        font.pointSize: attitudeRect.height*0.06
+        text: "ATTITUDE"
+    }
+
+    // ---- Altitude ----
+    Item {
+        x: altitudeRect.x; y: altitudeRect.y
+        width: altitudeRect.width; height: altitudeRect.height
+
+        HudTape {
+            x: parent.width*0.12; y: parent.height*0.08
+            width: parent.width*0.76; height: parent.height*0.84
+            kind: HudTape.Altitude
+            value: hud.altitudeFt
+            labelPointSize: parent.height*0.07
+        }
+        Box { anchors.fill: parent }
+        Box {
+            x: parent.width*0.20; y: parent.height*0.43
+            width: parent.width*0.60; height: parent.height*0.14
+            radius: 0
+            Label {
+                anchors.fill: parent
+                verticalAlignment: Text.AlignVCenter
+                font.pointSize: altitudeRect.height*0.12
+                text: hud.altitudeText
+            }
+        }
+        Label {
+            y: parent.height + 4; width: parent.width
+            font.pointSize: parent.height*0.07
+            text: "ALTITUDE"
+        }
+        Label {
+            y: parent.height*1.18; width: parent.width
+            font.pointSize: parent.height*0.07
+            text: hud.vspeedText
+        }
+    }
+
+    // ---- Roll / pitch readouts ----
+    Box {
+        x: bottomRect.x; y: bottomRect.y
+        width: bottomRect.width; height: bottomRect.height
+
+        Rectangle {   // divider
+            x: parent.width/2 - 1; width: 2; height: parent.height
+            color: root.ink
+        }
+        Repeater {
+            model: [ { title: "ROLL",  key: "rollText" },
+                     { title: "PITCH", key: "pitchText" } ]
+            Item {
+                x: index * parent.width/2; width: parent.width/2; height: parent.height
+                Label {
+                    y: 6; width: parent.width; height: parent.height*0.35
+                    verticalAlignment: Text.AlignVCenter
+                    font.pointSize: bottomRect.height*0.18
+                    text: modelData.title
+                }
+                Label {
+                    y: parent.height*0.35; width: parent.width; height: parent.height*0.55
+                    verticalAlignment: Text.AlignVCenter
+                    font.pointSize: bottomRect.height*0.26
+                    text: hud[modelData.key]
+                }
+            }
+        }
+    }
+
+    // ---- Icon buttons ----
+    Item {
+        x: iconsRect.x; y: iconsRect.y
+        width: iconsRect.width; height: iconsRect.height
+
+        Box {
+            width: parent.width*0.45; height: parent.height*0.60
+            radius: 4
+            Canvas {   // upper half-ellipse, as drawArc(0, 180); painted once
+                anchors.fill: parent
+                anchors.margins: 10
+                onPaint: {
+                    var ctx = getContext("2d");
+                    ctx.strokeStyle = root.ink;
+                    ctx.lineWidth = 2;
+                    ctx.lineCap = "round";
+                    ctx.beginPath();
+                    ctx.save();
+                    ctx.translate(width/2, height/2);
+                    ctx.scale(width/2, height/2);
+                    ctx.arc(0, 0, 1, Math.PI, 2*Math.PI, false);
+                    ctx.restore();
+                    ctx.stroke();
+                }
+            }
+        }
+        Box {
+            x: parent.width*0.52
+            width: parent.width*0.45; height: parent.height*0.60
+            radius: 4
+            Rectangle {
+                anchors.centerIn: parent
+                width: 12; height: 12; radius: 6
+                color: "transparent"
+                border.color: root.ink
+                border.width: 2
+            }
+        }
+    }
+}
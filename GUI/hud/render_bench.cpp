@@ -0,0 +1,290 @@
+// render_bench: offscreen frame cost of HudWidget and GridWidget.
+//
+// Each frame feeds one synthetic-flight sample (heading sweep, banking,
+// pitching, climbing/descending) through HudWidget::setSample() and renders
+// the whole widget into a QImage, i.e. every instrument is drawn as after
+// an expose. Runs at 720p / 1080p / 4K, antialiasing on and off, static
+// layer on and off, and reports mean and p99 ms for the frame and for each
+// draw function, then the static layer's off -> on frame-time change for
+// that size (the before/after of the cache). Uses the offscreen platform,
+// so no display is needed; --csv prints rows to diff against a baseline
+// run (x86 vs. Pi, before vs. after a change). --parallel runs HudWidget
+// with parallel rasterization (static layer on only; the breakdown is then
+// per-worker time).
+// --quality=N renders at a fixed QualityGovernor level. --warp applies a
+// keystone + barrel projector warp (full-frame remap every frame). --quick
+// adds the QtQuick HUD (HudQuickView, one grabWindow() per frame) and its
+// frame time against the QPainter HUD's (aa on, static layer on), on the
+// software scene graph; --quick=default leaves the backend to Qt
+// (QT_QUICK_BACKEND, else OpenGL, which needs a GL platform such as
+// QT_QPA_PLATFORM=eglfs or xcb instead of offscreen).
+//   ./render_bench [frames] [--csv] [--parallel] [--quality=N] [--warp]
+//                  [--quick[=default]]
+
+#include "HudWidget.h"
+#include "HudQuickView.h"
+#include "HudSample.h"
+#include "GridWidget.h"
+#include "WarpMesh.h"
+
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QImage>
+#include <QPainter>
+#include <QSGRendererInterface>
+#include <QSysInfo>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+static constexpr int kWarmup = 10;
+
+struct Series {
+    std::vector<double> ms;
+
+    double mean() const
+    {
+        double s = 0.0;
+        for (double v : ms) s += v;
+        return ms.empty() ? 0.0 : s / double(ms.size());
+    }
+
+    double p99() const
+    {
+        if (ms.empty()) return 0.0;
+        std::vector<double> v = ms;
+        const size_t k = size_t(std::ceil(0.99 * double(v.size()))) - 1;
+        std::nth_element(v.begin(), v.begin() + k, v.end());
+        return v[k];
+    }
+};
+
+// 60 Hz synthetic flight
+static HudSample flight(int frame)
+{
+    const double t = frame / 60.0;
+    HudSample s;
+    s.headingDeg = std::fmod(18.0 * t + 25.0 * std::sin(2.0 * M_PI * t / 7.0) + 360.0, 360.0);
+    s.rollDeg    = 35.0 * std::sin(2.0 * M_PI * t / 4.0);
+    s.pitchDeg   = 12.0 * std::sin(2.0 * M_PI * t / 3.0);
+    s.altitudeFt = 35000.0 + 1500.0 * std::sin(2.0 * M_PI * t / 9.0);
+    s.vspeedFpm  = 1500.0 * 2.0 * M_PI / 9.0 * 60.0 * std::cos(2.0 * M_PI * t / 9.0);
+    return s;
+}
+
+static bool g_csv = false;
+static bool g_parallel = false;
+static int  g_quality = 0;
+static bool g_warp = false;
+static bool g_quick = false;
+static bool g_quickDefault = false;   // scene graph backend left to Qt
+
+// A plausible combiner correction: some keystone, some barrel
+static WarpMesh benchWarp(const QSize& size)
+{
+    WarpParams p;
+    p.cornerX[0] = 0.04;  p.cornerY[0] = 0.02;
+    p.cornerX[1] = 0.97;  p.cornerY[1] = 0.00;
+    p.cornerX[2] = 1.00;  p.cornerY[2] = 0.97;
+    p.cornerX[3] = 0.01;  p.cornerY[3] = 1.00;
+    p.k1 = -0.06;
+    p.aspect = double(size.width()) / size.height();
+    return WarpMesh::fromParams(p);
+}
+
+static void report(const char* widget, const QSize& size, bool aa, const char* cache,
+                   const char* section, const Series& s)
+{
+    if (s.ms.empty()) return;
+    if (g_csv) {
+        std::printf("%s,%dx%d,%s,%s,%s,%.4f,%.4f\n", widget, size.width(), size.height(),
+                    aa ? "on" : "off", cache, section, s.mean(), s.p99());
+    } else {
+        std::printf("  %-20s %8.3f %8.3f\n", section, s.mean(), s.p99());
+    }
+}
+
+static void header(const char* widget, const QSize& size, bool aa, const char* cache)
+{
+    if (g_csv) return;
+    std::printf("%s %dx%d  aa=%s  static=%s            mean ms   p99 ms\n",
+                widget, size.width(), size.height(), aa ? "on" : "off", cache);
+}
+
+// Frame time of the whole render, for the static on/off comparison
+static Series benchHud(const QSize& size, bool aa, bool staticLayer, int frames)
+{
+    HudWidget hud;
+    hud.resize(size);
+    hud.setAntialiasing(aa);
+    hud.setStaticLayerEnabled(staticLayer);
+    hud.setSectionTiming(true);
+    hud.setParallelRaster(g_parallel);
+    hud.setQualityLevel(g_quality);
+    if (g_warp) hud.setWarp(benchWarp(size));
+
+    QImage img(size, QImage::Format_ARGB32_Premultiplied);
+    Series frame, heading, attitude, altitude, readouts, icons, warp;
+
+    for (int i = -kWarmup; i < frames; ++i) {
+        hud.setSample(flight(i + kWarmup));
+
+        QElapsedTimer t;
+        t.start();
+        hud.render(&img);
+        const double ms = t.nsecsElapsed() / 1e6;
+        if (i < 0) continue;
+
+        const HudWidget::SectionTimes st = hud.lastSectionTimes();
+        frame.ms.push_back(ms);
+        heading.ms.push_back(st.headingUs / 1000.0);
+        attitude.ms.push_back(st.attitudeUs / 1000.0);
+        altitude.ms.push_back(st.altitudeUs / 1000.0);
+        readouts.ms.push_back(st.readoutsUs / 1000.0);
+        if (!staticLayer) icons.ms.push_back(st.iconsUs / 1000.0);
+        if (g_warp) warp.ms.push_back(st.warpUs / 1000.0);
+    }
+
+    const char* cache = g_parallel ? "parallel" : staticLayer ? "on" : "off";
+    header("hud", size, aa, cache);
+    report("hud", size, aa, cache, "frame", frame);
+    report("hud", size, aa, cache, "drawHeadingTape", heading);
+    report("hud", size, aa, cache, "drawAttitude", attitude);
+    report("hud", size, aa, cache, "drawAltitudeTape", altitude);
+    report("hud", size, aa, cache, "drawBottomReadouts", readouts);
+    report("hud", size, aa, cache, "drawIconButtons", icons);
+    report("hud", size, aa, cache, "warp", warp);
+    return frame;
+}
+
+// One before -> after line, e.g. "static off -> on"
+static void compare(const QByteArray& what, const QSize& size, bool aa, const Series& before, const Series& after)
+{
+    if (g_csv || before.ms.empty() || after.ms.empty()) return;
+    const auto pct = [](double b, double a) { return b > 0.0 ? 100.0 * (a - b) / b : 0.0; };
+    std::printf("hud %dx%d  aa=%s  %s: mean %.3f -> %.3f ms (%+.1f%%), p99 %.3f -> %.3f ms (%+.1f%%)\n\n",
+                size.width(), size.height(), aa ? "on" : "off", what.constData(),
+                before.mean(), after.mean(), pct(before.mean(), after.mean()),
+                before.p99(), after.p99(), pct(before.p99(), after.p99()));
+}
+
+static const char* graphicsApiName(QSGRendererInterface::GraphicsApi api)
+{
+    switch (api) {
+    case QSGRendererInterface::Software:   return "software";
+    case QSGRendererInterface::OpenGL:     return "opengl";
+    case QSGRendererInterface::Direct3D12: return "d3d12";
+    case QSGRendererInterface::OpenVG:     return "openvg";
+    default:                               return "unknown";
+    }
+}
+
+// The QtQuick HUD: polish, sync and render of the whole scene per frame.
+// backend gets the scene graph backend that actually rendered.
+static Series benchQuick(const QSize& size, int frames, const char** backend)
+{
+    HudQuickView view;
+    view.resize(size);
+    view.show();
+
+    Series frame;
+    for (int i = -kWarmup; i < frames; ++i) {
+        view.setSample(flight(i + kWarmup));
+
+        QElapsedTimer t;
+        t.start();
+        const QImage img = view.grabWindow();
+        const double ms = t.nsecsElapsed() / 1e6;
+        if (i >= 0 && !img.isNull()) frame.ms.push_back(ms);
+    }
+
+    *backend = view.rendererInterface() ? graphicsApiName(view.rendererInterface()->graphicsApi()) : "none";
+    if (!g_csv)
+        std::printf("quick %dx%d  backend=%s            mean ms   p99 ms\n", size.width(), size.height(), *backend);
+    report("quick", size, true, *backend, "frame", frame);
+    return frame;
+}
+
+// GridWidget is static; what changes per frame is only that it is redrawn
+static void benchGrid(const QSize& size, int frames)
+{
+    GridWidget grid;
+    grid.resize(size);
+
+    QImage img(size, QImage::Format_ARGB32_Premultiplied);
+    Series frame;
+    for (int i = -kWarmup; i < frames; ++i) {
+        QElapsedTimer t;
+        t.start();
+        grid.render(&img);
+        const double ms = t.nsecsElapsed() / 1e6;
+        if (i >= 0) frame.ms.push_back(ms);
+    }
+
+    // GridWidget hard-codes antialiasing on
+    header("grid", size, true, "-");
+    report("grid", size, true, "-", "frame", frame);
+}
+
+int main(int argc, char* argv[])
+{
+    if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    // --quick: grabWindow() renders synchronously on the GUI thread
+    if (!qEnvironmentVariableIsSet("QSG_RENDER_LOOP"))
+        qputenv("QSG_RENDER_LOOP", "basic");
+    QApplication app(argc, argv);
+
+    int frames = 300;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--csv") == 0) g_csv = true;
+        else if (std::strcmp(argv[i], "--parallel") == 0) g_parallel = true;
+        else if (std::strncmp(argv[i], "--quality=", 10) == 0) g_quality = std::atoi(argv[i] + 10);
+        else if (std::strcmp(argv[i], "--warp") == 0) g_warp = true;
+        else if (std::strcmp(argv[i], "--quick") == 0) g_quick = true;
+        else if (std::strcmp(argv[i], "--quick=default") == 0) g_quick = g_quickDefault = true;
+        else frames = std::max(1, std::atoi(argv[i]));
+    }
+
+    const QSize sizes[] = { QSize(1280, 720), QSize(1920, 1080), QSize(3840, 2160) };
+
+    // Before the first QQuickWindow; takes precedence over QT_QUICK_BACKEND
+    if (g_quick && !g_quickDefault)
+        QQuickWindow::setSceneGraphBackend(QSGRendererInterface::Software);
+
+    if (g_csv) {
+        std::printf("widget,size,aa,static,section,mean_ms,p99_ms\n");
+    } else {
+        std::printf("%s, Qt %s, %s, %d frames (+%d warm-up), quality level %d%s\n\n",
+                    qPrintable(QSysInfo::currentCpuArchitecture()), qVersion(),
+                    qPrintable(QGuiApplication::platformName()), frames, kWarmup, g_quality,
+                    g_warp ? ", projector warp" : "");
+    }
+
+    for (const QSize& size : sizes) {
+        Series painterFrame;
+        for (bool aa : { true, false }) {
+            Series on, off;
+            for (bool staticLayer : { true, false }) {
+                if (g_parallel && !staticLayer) continue;
+                (staticLayer ? on : off) = benchHud(size, aa, staticLayer, frames);
+                if (!g_csv) std::printf("\n");
+            }
+            compare("static off -> on", size, aa, off, on);
+            if (aa) painterFrame = on;
+        }
+        if (g_quick) {
+            const char* backend = "";
+            const Series quick = benchQuick(size, frames, &backend);
+            if (!g_csv) std::printf("\n");
+            compare(QByteArray("QPainter -> QtQuick ") + backend, size, true, painterFrame, quick);
+        }
+        benchGrid(size, frames);
+        if (!g_csv) std::printf("\n");
+    }
+    return 0;
+}
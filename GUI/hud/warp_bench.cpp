@@ -0,0 +1,104 @@
+// warp_bench: per-frame cost of the projector warp (WarpRemap).
+//
+// Warps a synthetic 32-bit frame through a keystone + barrel mesh at the
+// given output size, portable path vs. SIMD, single thread vs. tile-row
+// bands on all cores, and checks that every variant is bit-identical to
+// the portable one. Also reports how far the per-tile LUT strays from the
+// exact inverse warp (in source pixels). Times are the best frame, which
+// is steadier than the mean on a busy machine.
+//   ./warp_bench [frames] [width] [height]
+
+#include "WarpMesh.h"
+#include "WarpRemap.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+int main(int argc, char* argv[])
+{
+    const int frames = (argc > 1) ? std::max(1, std::atoi(argv[1])) : 100;
+    const int w = (argc > 2) ? std::max(16, std::atoi(argv[2])) : 1920;
+    const int h = (argc > 3) ? std::max(16, std::atoi(argv[3])) : 1080;
+
+    // HUD-like content: dark background, thin bright lines, some gradients
+    std::vector<uint32_t> src(size_t(w) * h);
+    for (int y = 0; y < h; ++y) {
+        for (int x = 0; x < w; ++x) {
+            const bool line = (x % 64) == 0 || (y % 48) == 0 || std::abs(x - y) < 2;
+            const uint32_t g = line ? 255u : uint32_t((x * 7 + y * 3) & 63);
+            src[size_t(y) * w + x] = 0xff000000u | (uint32_t(x & 0xff) << 16) | (g << 8) | uint32_t(y & 0xff);
+        }
+    }
+
+    WarpParams p;
+    p.cornerX[0] = 0.04;  p.cornerY[0] = 0.02;
+    p.cornerX[1] = 0.97;  p.cornerY[1] = 0.00;
+    p.cornerX[2] = 1.00;  p.cornerY[2] = 0.97;
+    p.cornerX[3] = 0.01;  p.cornerY[3] = 1.00;
+    p.k1 = -0.06;
+    p.aspect = double(w) / h;
+    const WarpMesh mesh = WarpMesh::fromParams(p);
+
+    WarpRemap remap;
+    const auto b0 = std::chrono::steady_clock::now();
+    remap.build(mesh, w, h, w, h);
+    const double buildMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - b0).count();
+
+    using clock = std::chrono::steady_clock;
+    auto run = [&](bool simd, unsigned threads, std::vector<uint32_t>& out) {
+        out.assign(size_t(w) * h, 0u);
+        const int bands = int(std::max(1u, threads));
+        double best = 1e9;
+        for (int f = 0; f < frames; ++f) {
+            const auto t0 = clock::now();
+            std::vector<std::thread> pool;
+            for (int b = 1; b < bands; ++b) {
+                pool.emplace_back([&, b] {
+                    remap.apply(src.data(), w, out.data(), w,
+                                remap.tilesY() * b / bands, remap.tilesY() * (b + 1) / bands, nullptr, simd);
+                });
+            }
+            remap.apply(src.data(), w, out.data(), w, 0, remap.tilesY() / bands, nullptr, simd);
+            for (std::thread& t : pool) t.join();
+            best = std::min(best, std::chrono::duration<double, std::milli>(clock::now() - t0).count());
+        }
+        return best;
+    };
+
+    const unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<uint32_t> ref, s1, sN;
+    const double tp = run(false, 1, ref);
+    const double t1 = run(true, 1, s1);
+    const double tN = run(true, cores, sN);
+    auto same = [&](const std::vector<uint32_t>& o) {
+        return std::memcmp(o.data(), ref.data(), ref.size() * sizeof(uint32_t)) == 0;
+    };
+
+    // LUT error against the exact inverse, at every 7th pixel
+    double maxErr = 0.0;
+    for (int y = 0; y < h; y += 7) {
+        for (int x = 0; x < w; x += 7) {
+            double u, v, mu, mv;
+            if (!p.inverse((x + 0.5) / w, (y + 0.5) / h, u, v)) continue;
+            if (u < 0.0 || u > 1.0 || v < 0.0 || v > 1.0) continue;
+            mesh.map((x + 0.5) / w, (y + 0.5) / h, mu, mv);
+            maxErr = std::max(maxErr, std::hypot((mu - u) * w, (mv - v) * h));
+        }
+    }
+
+    const double mpix = double(w) * h / 1e6;
+    std::printf("%dx%d, %dx%d tiles, mesh %dx%d (build %.1f ms), %u threads\n",
+                w, h, remap.tilesX(), remap.tilesY(), mesh.cols(), mesh.rows(), buildMs, cores);
+    std::printf("mesh vs exact inverse: max %.2f px\n", maxErr);
+    std::printf("portable, 1 thread:  %7.2f ms  (%.0f Mpix/s)\n", tp, mpix * 1e3 / tp);
+    std::printf("simd, 1 thread:      %7.2f ms  x%.2f  bit-identical: %s\n", t1, tp / t1, same(s1) ? "yes" : "NO");
+    std::printf("simd, all cores:     %7.2f ms  x%.2f  bit-identical: %s\n", tN, tp / tN, same(sN) ? "yes" : "NO");
+    return (same(s1) && same(sN)) ? 0 : 1;
+}
@@ -1,4 +1,7 @@
 #include "ssd1306.h"
+#include "AltitudeFilter.h"
+#include "FastMath.h"
+#include "IdlePolicy.h"
 
 #include <QGuiApplication>
 #include <QImage>
@@ -8,11 +11,13 @@
 #include <atomic>
 #include <thread>
 #include <mutex>
+#include <condition_variable>
 #include <vector>
 #include <chrono>
 #include <iostream>
 #include <cmath>
 #include <cstring>
+#include <ctime>
 #include <fcntl.h>
 #include <unistd.h>
 #include <termios.h>
@@ -26,8 +31,18 @@ using json = nlohmann::json;
 // -----------------------------------------------------------
 static std::mutex altMutex;
 static double g_lastAltitudeFt = 0.0;
+static double g_lastVspeedFpm   = 0.0;
 static bool   g_haveAltitude    = false;
 
+// Bumped only when the values as shown on the OLED change, so the render
+// loop can sleep through a static picture
+static std::condition_variable altChanged;
+static unsigned g_shownSeq       = 0;
+
+// Hysteresis on the VS readout; baro noise would otherwise flicker its
+// last digit and keep the display awake at a steady altitude
+static const double VS_DEADBAND_FPM = 10.0;
+
 static const char* SERIAL_PORT = "/dev/serial/by-id/usb-Silicon_Labs_CP2102_USB_to_UART_Bridge_Controller_0001-if00-port0";
 static const int SERIAL_BAUD = B115200;
 
@@ -125,7 +140,7 @@ bool readAltitudeFrame(int fd, double& outAltFt) {
             std::cout << "Baseline: " << p0 << "\n";
         }
 
-        double alt_m = 44330.0 * (1.0 - pow(p / p0, 0.1903));
+        double alt_m = fastPressureAltitudeM(p, p0);
         outAltFt = alt_m * 3.28084;
         return true;
     }
@@ -141,13 +156,37 @@ void serialThread() {
     int fd = openSerial(SERIAL_PORT);
     std::cout << "Serial thread running\n";
 
+    // Frames only carry pressure, so this runs baro-only (no accel input):
+    // it smooths the altitude and gives us a vertical speed to show.
+    AltitudeFilter altFilter;
+    const auto t0 = std::chrono::steady_clock::now();
+    long long shownAlt = 0, shownVs = 0;
+
     while (true) {
         try {
             double alt;
             if (readAltitudeFrame(fd, alt)) {
+                const long long tsUs = std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - t0).count();
+                altFilter.update(tsUs, 0.0, true, alt / 3.28084);
+
+                const double altFt = altFilter.altitudeM() * 3.28084;
+                const double vsFpm = altFilter.vspeedMps() * 196.8504;
+
                 std::lock_guard<std::mutex> lk(altMutex);
-                g_lastAltitudeFt = alt;
+                const long long a = std::llround(altFt);
+                const long long v = std::fabs(vsFpm - shownVs) >= VS_DEADBAND_FPM
+                                        ? std::llround(vsFpm) : shownVs;
+                const bool changed = !g_haveAltitude || a != shownAlt || v != shownVs;
+                shownAlt = a;
+                shownVs = v;
+                g_lastAltitudeFt = (double)a;
+                g_lastVspeedFpm  = (double)v;
                 g_haveAltitude = true;
+                if (changed) {
+                    ++g_shownSeq;
+                    altChanged.notify_one();
+                }
             }
         } catch (...) {
             std::cerr << "Serial error, continuing…\n";
@@ -160,7 +199,7 @@ void serialThread() {
 // OLED helpers
 // -----------------------------------------------------------
 
-static QImage renderHUD(double altitudeFt, bool have) {
+static QImage renderHUD(double altitudeFt, double vspeedFpm, bool have) {
     const int W = SSD1306::Width;
     const int H = SSD1306::Height;
 
@@ -204,6 +243,9 @@ static QImage renderHUD(double altitudeFt, bool have) {
         small.setPointSize(7);
         p.setFont(small);
         p.drawText(bx+14, by+46, "FT");
+
+        // Vertical speed, bottom-left
+        p.drawText(4, H-4, QString("VS %1").arg((int)std::round(vspeedFpm)));
     }
 
     return img;
@@ -246,22 +288,72 @@ int main(int argc, char *argv[]) {
 
     std::cout << "HUD running…\n";
 
-    // Render loop: 12 FPS
+    // Render loop: at most 12 FPS, and only when the picture changes. Once
+    // it has been static for a while the loop wakes every 400 ms / 2 s
+    // instead of every 80 ms; a change from the serial thread wakes it
+    // early, so the next frame still goes out within one frame period.
+    using Clock = std::chrono::steady_clock;
+    const auto framePeriod = std::chrono::milliseconds(80);
+    const auto nowUs = []{
+        return (int64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+            Clock::now().time_since_epoch()).count();
+    };
+
+    IdlePolicy idle;
+    idle.setIdleAfterUs(2000000);
+    idle.setDeepAfterUs(10000000);
+    idle.setDividers(5, 25);
+
+    unsigned drawnSeq = ~0u;
+    int renders = 0, wakeups = 0;
+    auto statsAt = Clock::now() + std::chrono::seconds(10);
+    std::clock_t cpuAt = std::clock();
+
     while (true) {
-        double alt;
+        const auto frameStart = Clock::now();
+        double alt, vs;
         bool have;
+        unsigned seq;
         {
             std::lock_guard<std::mutex> lk(altMutex);
             alt = g_lastAltitudeFt;
+            vs = g_lastVspeedFpm;
             have = g_haveAltitude;
+            seq = g_shownSeq;
         }
 
-        QImage frame = renderHUD(alt, have);
-        auto buf = toBuffer(frame);
-
-        oled.update(buf);
+        const bool changed = seq != drawnSeq;
+        if (changed) {
+            QImage frame = renderHUD(alt, vs, have);
+            auto buf = toBuffer(frame);
+            oled.update(buf);
+            drawnSeq = seq;
+            ++renders;
+        }
+        const int divider = idle.update(changed, nowUs());
+
+        if (frameStart >= statsAt) {
+            const IdlePolicy::Stats st = idle.takeStats(nowUs());
+            const std::clock_t cpu = std::clock();
+            std::cout << "oled renders=" << renders << " wakeups=" << wakeups
+                      << " idle=" << std::lround(st.idleFraction * 100.0) << "%"
+                      << " cpu=" << (1000.0 * (cpu - cpuAt) / CLOCKS_PER_SEC) << "ms/10s\n";
+            renders = wakeups = 0;
+            cpuAt = cpu;
+            statsAt = frameStart + std::chrono::seconds(10);
+        }
 
-        std::this_thread::sleep_for(std::chrono::milliseconds(80));
+        if (divider > 1) {
+            std::unique_lock<std::mutex> lk(altMutex);
+            if (altChanged.wait_until(lk, frameStart + divider * framePeriod,
+                                      [&]{ return g_shownSeq != drawnSeq; })) {
+                lk.unlock();
+                idle.wake(nowUs());
+            }
+        }
+        // Frame cap, also after an early wake
+        std::this_thread::sleep_until(frameStart + framePeriod);
+        ++wakeups;
     }
 
     return 0;